@@ -0,0 +1,95 @@
+#include "benchfixtures.h"
+#include "app/headlessrunner.h"
+#include "network/dataprovider.h"
+#include <QtTest>
+#include <QRandomGenerator>
+
+OhlcvSeries BenchFixtures::makeSeries(int count, qint64 barInterval)
+{
+    OhlcvSeries series;
+    series.reserve(count);
+
+    QRandomGenerator rng(42);
+    qint64 time = QDateTime(QDate(2000, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+    double lastClose = 20.0;
+
+    for (int i = 0; i < count; ++i) {
+        double open = lastClose * (1.0 + rng.bounded(0.02) - 0.01);
+        double close = open * (1.0 + rng.bounded(0.1) - 0.05);
+        double high = qMax(open, close) * (1.0 + rng.bounded(0.03));
+        double low = qMin(open, close) * (1.0 - rng.bounded(0.03));
+        double volume = 500000 + rng.bounded(4500000);
+
+        series.append(time, open, high, low, close, volume);
+        time += barInterval;
+        lastClose = close;
+    }
+
+    return series;
+}
+
+StockItem BenchFixtures::makeStock(const QString& code, int bars)
+{
+    StockItem item(code, code);
+    if (bars <= 0) {
+        return item;
+    }
+
+    const OhlcvSeries series = makeSeries(bars, 24 * 3600 * 1000LL);
+
+    QVector<StockTradeData> kLineData;
+    kLineData.reserve(bars);
+    for (int i = 0; i < bars; ++i) {
+        StockTradeData data;
+        data.timestamp = QDateTime::fromMSecsSinceEpoch(series.time()[i]);
+        data.open = series.open()[i];
+        data.high = series.high()[i];
+        data.low = series.low()[i];
+        data.close = series.close()[i];
+        data.volume = static_cast<long long>(series.volume()[i]);
+        data.amount = data.volume * data.close;
+        kLineData.append(data);
+    }
+
+    item.setKLineData(kLineData);
+    item.setPreviousClose(kLineData.last().close);
+    item.setCurrentPrice(kLineData.last().close);
+    return item;
+}
+
+MarketData BenchFixtures::makeMarketData(int count)
+{
+    DataProvider provider;
+    provider.setSimulatedStocks(makeSimulatedStocks(count));
+    return provider.generateSimulatedData();
+}
+
+MarketData BenchFixtures::makeIntradayData(int count, const QDate& date)
+{
+    const QMap<QString, QString> stocks = makeSimulatedStocks(count);
+    MarketData marketData;
+
+    // 模拟器与网络请求一样异步送回，等全部到齐
+    DataProvider provider;
+    int loaded = 0;
+    QObject::connect(&provider, &DataProvider::intradayHistoryLoaded,
+                     [&](const QString& code, const QDate&, const QVector<TimeSeriesPoint>& points, bool) {
+        ++loaded;
+        if (points.isEmpty()) {
+            return;
+        }
+
+        StockItem item(code, stocks.value(code));
+        item.setTimeSeriesData(points);
+        item.setPreviousClose(points.first().price);
+        item.setCurrentPrice(points.last().price);
+        marketData.addOrUpdateStock(item);
+    });
+
+    for (auto it = stocks.cbegin(); it != stocks.cend(); ++it) {
+        provider.requestIntradayHistory(it.key(), date);
+    }
+    QTest::qWaitFor([&]() { return loaded == stocks.size(); });
+
+    return marketData;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "data/marketdata.h"
+#include "data/ohlcvseries.h"
+#include <QDate>
+#include <QString>
+
+/**
+ * @brief 各组基准测试共用的测试数据
+ *
+ * 行情和分时数据由生产代码的模拟器生成；K线用固定种子生成，每次运行的数据相同
+ */
+class BenchFixtures
+{
+public:
+    /**
+     * @brief 生成模拟K线数据，从2000-01-01开始
+     * @param count K线数量
+     * @param barInterval K线周期（毫秒）
+     */
+    static OhlcvSeries makeSeries(int count, qint64 barInterval = 60 * 1000);
+
+    /**
+     * @brief 生成带日K线的股票，K线与makeSeries相同
+     * @param code 股票代码
+     * @param bars K线数量
+     */
+    static StockItem makeStock(const QString& code, int bars);
+
+    /**
+     * @brief 生成一次刷新的模拟行情
+     * @param count 股票数量
+     */
+    static MarketData makeMarketData(int count);
+
+    /**
+     * @brief 用模拟器加载指定交易日的完整分时数据
+     * @param count 股票数量
+     * @param date 交易日（最近30天内的往日）
+     */
+    static MarketData makeIntradayData(int count, const QDate& date);
+};
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "benchsuites.h"
+#include <QApplication>
+#include <QDir>
+#include <QVector>
+#include <functional>
+
+/**
+ * @brief 依次运行所有基准测试
+ *
+ * 除QtTest自带的参数外，支持：
+ *   --output-dir <目录>  每组结果另存为<目录>/<组名>.xml（QtTest XML格式，含每项的耗时），
+ *                        控制台仍输出文本结果，便于脚本比较不同版本的结果
+ *   --suite <组名>       只运行指定的一组，可以重复
+ * 例如：QuoteClientBench --output-dir results --suite MarketDataBench -median 5
+ */
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    struct Suite {
+        QString name;
+        std::function<int(const QStringList&)> run;
+    };
+
+    const QVector<Suite> suites = {
+        {"CandlestickBench", runCandlestickBench},
+        {"MarketDataBench", runMarketDataBench},
+        {"QuoteViewBench", runQuoteViewBench}
+    };
+
+    // 取出自定义参数，其余原样交给QtTest
+    QStringList arguments;
+    QStringList selected;
+    QString outputDir;
+
+    const QStringList all = app.arguments();
+    for (int i = 0; i < all.size(); ++i) {
+        if (all[i] == "--output-dir" && i + 1 < all.size()) {
+            outputDir = all[++i];
+        } else if (all[i] == "--suite" && i + 1 < all.size()) {
+            selected.append(all[++i]);
+        } else {
+            arguments.append(all[i]);
+        }
+    }
+
+    if (!outputDir.isEmpty()) {
+        QDir().mkpath(outputDir);
+    }
+
+    int failures = 0;
+    for (const Suite& suite : suites) {
+        if (!selected.isEmpty() && !selected.contains(suite.name)) {
+            continue;
+        }
+
+        QStringList suiteArguments = arguments;
+        if (!outputDir.isEmpty()) {
+            QString file = QDir(outputDir).filePath(suite.name + ".xml");
+            suiteArguments << "-o" << file + ",xml" << "-o" << "-,txt";
+        }
+
+        failures += suite.run(suiteArguments);
+    }
+
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QStringList>
+
+/**
+ * @brief 各组基准测试的入口
+ *
+ * 每组是一个QtTest测试类，由benchmain.cpp依次运行；
+ * 参数与QTest::qExec相同，返回失败的测试数量
+ */
+int runCandlestickBench(const QStringList& arguments);
+int runMarketDataBench(const QStringList& arguments);
+int runQuoteViewBench(const QStringList& arguments);
\ No newline at end of file
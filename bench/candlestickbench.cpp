@@ -0,0 +1,172 @@
+#include "benchsuites.h"
+#include "benchfixtures.h"
+#include "ui/candlestickrenderer.h"
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QtCharts/QChartView>
+#include <QtCharts/QCandlestickSeries>
+#include <QtCharts/QCandlestickSet>
+#include <QtCharts/QBarSeries>
+#include <QtCharts/QBarSet>
+
+QT_CHARTS_USE_NAMESPACE
+
+/**
+ * @brief K线图绘制基准测试
+ *
+ * 比较CandlestickRenderer与QtCharts QCandlestickSeries在不同K线数量下的单帧绘制耗时，
+ * 以及静态层缓存后每次行情推送在GUI线程上的合成耗时；
+ * QtCharts为每根K线创建对象，100万根时默认跳过，设置QUOTECLIENT_BENCH_FULL=1后运行
+ */
+class CandlestickBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void customRenderer_data();
+    void customRenderer();
+    void liveComposite_data();
+    void liveComposite();
+    void qtChartsRenderer_data();
+    void qtChartsRenderer();
+
+private:
+    /**
+     * @brief 生成绘制参数，显示全部K线
+     * @param count K线数量
+     */
+    static CandlestickRenderer::Frame makeFrame(int count);
+
+    /**
+     * @brief 添加测试数据行
+     */
+    static void addRows();
+};
+
+static const QSize kFrameSize(1280, 720);
+
+CandlestickRenderer::Frame CandlestickBench::makeFrame(int count)
+{
+    CandlestickRenderer::Frame frame;
+    frame.series = BenchFixtures::makeSeries(count);
+    frame.viewFirst = 0.0;
+    frame.viewCount = count;
+    frame.size = kFrameSize;
+    frame.timeFormat = "MM-dd";
+    frame.baseColor = Qt::white;
+    frame.textColor = Qt::black;
+    return frame;
+}
+
+void CandlestickBench::addRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void CandlestickBench::customRenderer_data()
+{
+    addRows();
+}
+
+void CandlestickBench::customRenderer()
+{
+    QFETCH(int, count);
+
+    CandlestickRenderer renderer;
+    CandlestickRenderer::Frame frame = makeFrame(count);
+
+    QImage image(kFrameSize, QImage::Format_ARGB32_Premultiplied);
+
+    // 完整一帧：静态层加实时K线
+    QBENCHMARK {
+        QPainter painter(&image);
+        CandlestickRenderer::Scale scale = CandlestickRenderer::computeScale(frame);
+        renderer.renderStatic(painter, frame, scale);
+        renderer.renderLive(painter, frame, scale);
+    }
+}
+
+void CandlestickBench::liveComposite_data()
+{
+    addRows();
+}
+
+void CandlestickBench::liveComposite()
+{
+    QFETCH(int, count);
+
+    CandlestickRenderer renderer;
+    CandlestickRenderer::Frame frame = makeFrame(count);
+    CandlestickRenderer::Scale scale = CandlestickRenderer::computeScale(frame);
+
+    QImage layer(kFrameSize, QImage::Format_ARGB32_Premultiplied);
+    {
+        QPainter painter(&layer);
+        renderer.renderStatic(painter, frame, scale);
+    }
+
+    QImage image(kFrameSize, QImage::Format_ARGB32_Premultiplied);
+
+    // 行情推送时GUI线程的工作：合成缓存的静态层并绘制实时K线
+    QBENCHMARK {
+        QPainter painter(&image);
+        painter.drawImage(0, 0, layer);
+        renderer.renderLive(painter, frame, scale);
+    }
+}
+
+void CandlestickBench::qtChartsRenderer_data()
+{
+    addRows();
+}
+
+void CandlestickBench::qtChartsRenderer()
+{
+    QFETCH(int, count);
+
+    if (count > 100000 && qEnvironmentVariableIntValue("QUOTECLIENT_BENCH_FULL") == 0) {
+        QSKIP("QtCharts needs one QObject per bar; set QUOTECLIENT_BENCH_FULL=1 to run");
+    }
+
+    OhlcvSeries series = BenchFixtures::makeSeries(count);
+
+    // 与原QuoteChart::createCandlestickChart相同的构建方式
+    QCandlestickSeries *candleSeries = new QCandlestickSeries();
+    QBarSeries *volumeSeries = new QBarSeries();
+    QBarSet *volumeSet = new QBarSet(QString());
+
+    for (int i = 0; i < series.size(); ++i) {
+        candleSeries->append(new QCandlestickSet(series.open()[i], series.high()[i], series.low()[i],
+                                                 series.close()[i], series.time()[i]));
+        *volumeSet << series.volume()[i];
+    }
+    volumeSeries->append(volumeSet);
+
+    QChart *chart = new QChart();
+    chart->legend()->hide();
+    chart->addSeries(candleSeries);
+    chart->addSeries(volumeSeries);
+    chart->createDefaultAxes();
+
+    QChartView view(chart);
+    view.resize(kFrameSize);
+
+    QImage image(kFrameSize, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        view.render(&image);
+    }
+}
+
+int runCandlestickBench(const QStringList& arguments)
+{
+    CandlestickBench bench;
+    return QTest::qExec(&bench, arguments);
+}
+
+#include "candlestickbench.moc"
\ No newline at end of file
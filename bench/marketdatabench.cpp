@@ -0,0 +1,238 @@
+#include "benchsuites.h"
+#include "benchfixtures.h"
+#include "network/dataprovider.h"
+#include "app/headlessrunner.h"
+#include "data/marketdata.h"
+#include "data/quoteindex.h"
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+/**
+ * @brief 数据层基准测试
+ *
+ * 测量行情解析、模拟行情生成、MarketData增改查和QuoteIndex批量查询在100、1千、1万只股票下的耗时，
+ * 每次刷新都会走这些路径，耗时应随股票数量线性增长
+ */
+class MarketDataBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseMarketData_data();
+    void parseMarketData();
+    void generateSimulatedData_data();
+    void generateSimulatedData();
+    void addOrUpdateStock_data();
+    void addOrUpdateStock();
+    void getStock_data();
+    void getStock();
+    void getStocksByMarketType_data();
+    void getStocksByMarketType();
+    void quoteIndexFill_data();
+    void quoteIndexFill();
+    void quoteIndexRank_data();
+    void quoteIndexRank();
+
+private:
+    /**
+     * @brief 把行情编码成parseMarketData接受的JSON
+     */
+    static QByteArray toJson(const MarketData& marketData);
+
+    /**
+     * @brief 添加测试数据行
+     */
+    static void addRows();
+};
+
+QByteArray MarketDataBench::toJson(const MarketData& marketData)
+{
+    QJsonArray stocks;
+    for (const StockItem& item : marketData.getAllStocks()) {
+        QJsonObject stock;
+        stock["code"] = item.getCode();
+        stock["name"] = item.getName();
+        stock["current"] = item.getCurrentPrice();
+        stock["open"] = item.getOpenPrice();
+        stock["high"] = item.getHighPrice();
+        stock["low"] = item.getLowPrice();
+        stock["previous"] = item.getPreviousClose();
+        stock["volume"] = item.getVolume();
+        stock["amount"] = item.getAmount();
+        stocks.append(stock);
+    }
+
+    QJsonObject root;
+    root["stocks"] = stocks;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+void MarketDataBench::addRows()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void MarketDataBench::parseMarketData_data()
+{
+    addRows();
+}
+
+void MarketDataBench::parseMarketData()
+{
+    QFETCH(int, count);
+
+    DataProvider provider;
+    QByteArray json = toJson(BenchFixtures::makeMarketData(count));
+
+    QBENCHMARK {
+        // 每次迭代结束时释放结果，与网络回复的处理一致，下一次解析不需要复制
+        MarketData marketData;
+        provider.parseMarketData(json, &marketData);
+    }
+}
+
+void MarketDataBench::generateSimulatedData_data()
+{
+    addRows();
+}
+
+void MarketDataBench::generateSimulatedData()
+{
+    QFETCH(int, count);
+
+    DataProvider provider;
+    provider.setSimulatedStocks(makeSimulatedStocks(count));
+
+    // 首次生成每只股票的K线和分时数据，之后测量的是在原有状态上推进一次行情
+    provider.generateSimulatedData();
+    QBENCHMARK {
+        MarketData marketData = provider.generateSimulatedData();
+        Q_UNUSED(marketData);
+    }
+}
+
+void MarketDataBench::addOrUpdateStock_data()
+{
+    addRows();
+}
+
+void MarketDataBench::addOrUpdateStock()
+{
+    QFETCH(int, count);
+
+    MarketData source = BenchFixtures::makeMarketData(count);
+    const QList<StockItem> items = source.getAllStocks().values();
+
+    // 先全部添加，再全部更新一遍，与连续两次刷新相同
+    QBENCHMARK {
+        MarketData marketData;
+        for (const StockItem& item : items) {
+            marketData.addOrUpdateStock(item);
+        }
+        for (const StockItem& item : items) {
+            marketData.addOrUpdateStock(item);
+        }
+    }
+}
+
+void MarketDataBench::getStock_data()
+{
+    addRows();
+}
+
+void MarketDataBench::getStock()
+{
+    QFETCH(int, count);
+
+    MarketData marketData = BenchFixtures::makeMarketData(count);
+    const QStringList codes = marketData.getAllStockCodes();
+
+    int found = 0;
+    QBENCHMARK {
+        for (const QString& code : codes) {
+            if (marketData.getStock(code)) {
+                ++found;
+            }
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void MarketDataBench::getStocksByMarketType_data()
+{
+    addRows();
+}
+
+void MarketDataBench::getStocksByMarketType()
+{
+    QFETCH(int, count);
+
+    MarketData marketData = BenchFixtures::makeMarketData(count);
+
+    QBENCHMARK {
+        QStringList codes = marketData.getStocksByMarketType(StockItem::MarketType::ChiNext);
+        Q_UNUSED(codes);
+    }
+}
+
+void MarketDataBench::quoteIndexFill_data()
+{
+    addRows();
+}
+
+void MarketDataBench::quoteIndexFill()
+{
+    QFETCH(int, count);
+
+    QuoteIndex index;
+    index.update(BenchFixtures::makeMarketData(count));
+    const QVector<int>& ids = index.boardSymbols(StockItem::MarketType::ChiNext);
+
+    // 与getStocksByMarketType加逐个getStock相同的结果，一次调用写入连续数组
+    QVector<double> prices(ids.size());
+    QVector<double> changes(ids.size());
+    QuoteIndex::Columns columns;
+    columns.currentPrice = prices.data();
+    columns.changePercent = changes.data();
+
+    int found = 0;
+    QBENCHMARK {
+        found = index.fill(ids.constData(), ids.size(),
+                           QuoteIndex::CurrentPriceField | QuoteIndex::ChangePercentField, columns);
+    }
+    QCOMPARE(found, ids.size());
+}
+
+void MarketDataBench::quoteIndexRank_data()
+{
+    addRows();
+}
+
+void MarketDataBench::quoteIndexRank()
+{
+    QFETCH(int, count);
+
+    MarketData marketData = BenchFixtures::makeMarketData(count);
+    QuoteIndex index;
+    QVector<int> ids(20);
+
+    // 每次行情更新后重建索引并取涨幅前20名
+    QBENCHMARK {
+        index.update(marketData);
+        index.rankRange(QuoteIndex::ChangePercentField, Qt::DescendingOrder, 0, ids.size(), ids.data());
+    }
+}
+
+int runMarketDataBench(const QStringList& arguments)
+{
+    MarketDataBench bench;
+    return QTest::qExec(&bench, arguments);
+}
+
+#include "marketdatabench.moc"
\ No newline at end of file
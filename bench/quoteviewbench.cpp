@@ -0,0 +1,148 @@
+#include "benchsuites.h"
+#include "benchfixtures.h"
+#include "data/tradingcalendar.h"
+#include "ui/quotemodel.h"
+#include "ui/stocktable.h"
+#include "ui/quotechart.h"
+#include "ui/sparklinegrid.h"
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QImage>
+
+/**
+ * @brief 界面层基准测试
+ *
+ * 测量行情刷新时表格模型的更新耗时（100、1千、1万只股票，模型上挂一个表格视图），
+ * 切换股票时K线图的完整构建耗时（100、1千、1万根K线），
+ * 以及500个单元格的分时走势网格每帧重新计算并绘制的耗时（目标60帧/秒）；
+ * K线图的静态层在工作线程中绘制，这里测的是GUI线程上的准备工作
+ */
+class QuoteViewBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void quoteModelUpdate_data();
+    void quoteModelUpdate();
+    void candlestickChart_data();
+    void candlestickChart();
+    void sparklineGrid();
+};
+
+void QuoteViewBench::quoteModelUpdate_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void QuoteViewBench::quoteModelUpdate()
+{
+    QFETCH(int, count);
+
+    // 两次刷新交替推送，每次大部分股票的价格都有变化
+    const MarketData snapshots[2] = {BenchFixtures::makeMarketData(count), BenchFixtures::makeMarketData(count)};
+
+    QuoteModel model;
+    StockTable table(&model);
+    model.setMarketData(snapshots[1]);
+
+    // 按最坏情况模拟订阅回调：每只股票的价格和成交都有变化
+    QVector<DataManager::StockUpdate> updates;
+    updates.reserve(count);
+    for (const QString& code : snapshots[0].getAllStocks().keys()) {
+        updates.append({code, DataManager::PriceField | DataManager::VolumeField});
+    }
+
+    int next = 0;
+    QBENCHMARK {
+        model.markChanged(updates);
+        model.setMarketData(snapshots[next]);
+        next ^= 1;
+    }
+}
+
+void QuoteViewBench::candlestickChart_data()
+{
+    QTest::addColumn<int>("bars");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void QuoteViewBench::candlestickChart()
+{
+    QFETCH(int, bars);
+
+    // 在两只股票之间切换，关闭图表数据缓存，每次都完整重建
+    const StockItem stocks[2] = {BenchFixtures::makeStock("600000", bars), BenchFixtures::makeStock("000001", bars)};
+
+    QuoteChart chart;
+    chart.resize(1280, 720);
+    chart.setRenderCacheBudget(0);
+    chart.setChartType(QuoteChart::ChartType::Candlestick);
+
+    int next = 0;
+    QBENCHMARK {
+        chart.updateChart(stocks[next]);
+        next ^= 1;
+    }
+}
+
+void QuoteViewBench::sparklineGrid()
+{
+    // 一帧的时间预算（毫秒），对应60帧/秒
+    const double kFrameBudgetMs = 1000.0 / 60.0;
+    const int kCells = 500;
+
+    // 两个交易日的分时交替推送，每个单元格的折线都要重新计算
+    const TradingCalendar& calendar = TradingCalendar::weekdays();
+    QDate day = calendar.previousTradingDay(TradingCalendar::currentTime().date());
+    const MarketData snapshots[2] = {BenchFixtures::makeIntradayData(kCells, day),
+                                     BenchFixtures::makeIntradayData(kCells, calendar.previousTradingDay(day))};
+    const QStringList codes = snapshots[0].getAllStocks().keys();
+    QCOMPARE(codes.size(), kCells);
+
+    SparklineGrid grid;
+    grid.setCodes(codes);
+    grid.resize(1280, grid.heightForWidth(1280));
+    grid.refresh(snapshots[1]);
+
+    // 绘制整个网格，相当于所有单元格都在可见区域内
+    QImage frame(grid.size(), QImage::Format_ARGB32_Premultiplied);
+    int next = 0;
+    auto renderFrame = [&]() {
+        grid.markChanged(codes);
+        grid.refresh(snapshots[next]);
+        grid.render(&frame);
+        next ^= 1;
+    };
+
+    QBENCHMARK {
+        renderFrame();
+    }
+
+    // 单独计时若干帧与预算比较，超出时只告警，避免在较慢的机器上失败
+    const int kFrames = 60;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < kFrames; ++i) {
+        renderFrame();
+    }
+    double frameMs = timer.nsecsElapsed() / 1e6 / kFrames;
+    if (frameMs > kFrameBudgetMs) {
+        qWarning("sparklineGrid: %.2f ms per frame exceeds the 60 fps budget of %.2f ms",
+                 frameMs, kFrameBudgetMs);
+    }
+}
+
+int runQuoteViewBench(const QStringList& arguments)
+{
+    QuoteViewBench bench;
+    return QTest::qExec(&bench, arguments);
+}
+
+#include "quoteviewbench.moc"
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "application.h"
+#include <QStandardPaths>
+#include <QDir>
 
 Application::Application(QObject *parent)
     : QObject(parent)
@@ -21,15 +23,49 @@ void Application::initialize()
     connect(m_dataProvider.get(), &DataProvider::dataReceived,
             m_dataManager.get(), &DataManager::updateMarketData);
     
+    // 历史K线和往日分时从数据提供者按需异步加载，结果送回历史缓存
+    DataProvider *provider = m_dataProvider.get();
+    m_dataManager->kLineHistory()->setLoader(
+        [provider](const QString& code, qint64 barInterval, qint64 endTime, int count) {
+            provider->requestKLineHistory(code, barInterval, endTime, count);
+        });
+    connect(provider, &DataProvider::kLineHistoryLoaded,
+            m_dataManager->kLineHistory(), &KLineHistory::insertChunk);
+    m_dataManager->intradayHistory()->setLoader(
+        [provider](const QString& code, const QDate& date) {
+            provider->requestIntradayHistory(code, date);
+        });
+    connect(provider, &DataProvider::intradayHistoryLoaded,
+            m_dataManager->intradayHistory(), &IntradayHistory::insertDay);
+    
+    // 数据管理器按交易阶段发出刷新请求，由数据提供者获取行情；
+    // 节假日表可放在应用数据目录的holidays.txt中
+    connect(m_dataManager.get(), &DataManager::refreshRequested,
+            m_dataProvider.get(), &DataProvider::onRefreshRequested);
+    
+    // 行情延迟统计，每分钟追加写入日志
+    QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(logDir);
+    m_latencyMonitor = std::make_unique<LatencyMonitor>();
+    m_latencyMonitor->setLogFile(QDir(logDir).filePath("latency.log"));
+    m_latencyMonitor->setDumpInterval(60 * 1000);
+    
+    m_dataManager->tradingCalendar()->loadHolidays(QDir(logDir).filePath("holidays.txt"));
+    m_dataProvider->setTradingCalendar(m_dataManager->tradingCalendar());
+    m_dataManager->setRefreshInterval(3000);
+    
     // 创建主窗口
     m_mainWindow = std::make_unique<MainWindow>();
+    m_mainWindow->setDataManager(m_dataManager.get());
+    m_mainWindow->setLatencyMonitor(m_latencyMonitor.get());
     
     // 连接数据管理器和UI
     connect(m_dataManager.get(), &DataManager::marketDataUpdated,
             m_mainWindow.get(), &MainWindow::updateUI);
     
-    // 启动数据提供者
+    // 启动数据提供者和自动刷新
     m_dataProvider->start();
+    m_dataManager->startAutoRefresh();
     
     // 显示主窗口
     m_mainWindow->show();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mainwindow.h"
+#include "latencymonitor.h"
 #include "../data/datamanager.h"
 #include "../network/dataprovider.h"
 
@@ -28,6 +29,9 @@ public:
     void initialize();
 
 private:
+    // 行情延迟统计（主窗口持有其指针，需晚于主窗口析构）
+    std::unique_ptr<LatencyMonitor> m_latencyMonitor;
+    
     // UI组件
     std::unique_ptr<MainWindow> m_mainWindow;
     
@@ -36,4 +40,5 @@ private:
     
     // 网络数据提供者
     std::unique_ptr<DataProvider> m_dataProvider;
+
 }; 
\ No newline at end of file
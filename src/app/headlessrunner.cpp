@@ -0,0 +1,185 @@
+#include "headlessrunner.h"
+#include "../data/memoryaccounting.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+HeadlessRunner::HeadlessRunner(const Options& options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_table(nullptr)
+    , m_feedPosition(0)
+    , m_elapsedMs(0)
+    , m_updates(0)
+    , m_stockUpdates(0)
+    , m_peakResident(0)
+{
+    connect(&m_dataManager, &DataManager::marketDataUpdated, this, &HeadlessRunner::onMarketDataUpdated);
+    connect(&m_feedTimer, &QTimer::timeout, this, &HeadlessRunner::onFeedTimer);
+    connect(&m_memoryTimer, &QTimer::timeout, this, &HeadlessRunner::onMemoryTimer);
+
+    if (m_options.render) {
+        m_table = new StockTable(&m_model);
+        m_table->resize(1280, 720);
+        m_frame = QImage(m_table->size(), QImage::Format_ARGB32_Premultiplied);
+    }
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    delete m_table;
+}
+
+bool HeadlessRunner::start()
+{
+    if (!m_options.feedFile.isEmpty()) {
+        QFile file(m_options.feedFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine().trimmed();
+            if (!line.isEmpty()) {
+                m_feed.append(line);
+            }
+        }
+
+        if (m_feed.isEmpty()) {
+            return false;
+        }
+    } else {
+        m_provider.setSimulatedStocks(makeSimulatedStocks(m_options.symbols));
+    }
+
+    m_clock.start();
+    m_feedTimer.start(m_options.intervalMs);
+    m_memoryTimer.start(1000);
+    onMemoryTimer();
+    return true;
+}
+
+QString HeadlessRunner::report(bool json) const
+{
+    double seconds = m_elapsedMs / 1000.0;
+    double updatesPerSecond = seconds > 0.0 ? m_updates / seconds : 0.0;
+    double stocksPerSecond = seconds > 0.0 ? m_stockUpdates / seconds : 0.0;
+
+    if (json) {
+        QJsonObject stages;
+        for (int i = 0; i < LatencyMonitor::StageCount; ++i) {
+            const LatencyHistogram& histogram = m_latencyMonitor.histogram(LatencyMonitor::Stage(i));
+            QJsonObject stage;
+            stage["count"] = qint64(histogram.count());
+            stage["p50"] = histogram.percentile(50.0);
+            stage["p99"] = histogram.percentile(99.0);
+            stage["p999"] = histogram.percentile(99.9);
+            stage["max"] = histogram.max();
+            stages[LatencyMonitor::stageName(LatencyMonitor::Stage(i))] = stage;
+        }
+
+        QJsonObject root;
+        root["seconds"] = seconds;
+        root["updates"] = qint64(m_updates);
+        root["updatesPerSecond"] = updatesPerSecond;
+        root["stockUpdatesPerSecond"] = stocksPerSecond;
+        root["latencyMicros"] = stages;
+        QJsonObject memory;
+        for (int i = 0; i < MemoryAccounting::TagCount; ++i) {
+            MemoryAccounting::Usage usage = MemoryAccounting::usage(MemoryAccounting::Tag(i));
+            QJsonObject tag;
+            tag["bytes"] = usage.bytes;
+            tag["peakBytes"] = usage.peakBytes;
+            tag["blocks"] = usage.blocks;
+            tag["allocations"] = qint64(usage.allocations);
+            memory[MemoryAccounting::tagName(MemoryAccounting::Tag(i))] = tag;
+        }
+
+        root["peakResidentBytes"] = m_peakResident;
+        root["memory"] = memory;
+        return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    }
+
+    QString text;
+    text += QString("updates: %1 in %2 s (%3 updates/s, %4 stock updates/s)\n")
+            .arg(m_updates)
+            .arg(seconds, 0, 'f', 2)
+            .arg(updatesPerSecond, 0, 'f', 1)
+            .arg(stocksPerSecond, 0, 'f', 0);
+    text += "latency (us):\n";
+    text += m_latencyMonitor.summary();
+    text += QString("memory: peak resident %1 MB\n").arg(m_peakResident / (1024.0 * 1024.0), 0, 'f', 1);
+    for (int i = 0; i < MemoryAccounting::TagCount; ++i) {
+        MemoryAccounting::Usage usage = MemoryAccounting::usage(MemoryAccounting::Tag(i));
+        text += QString("  %1 %2 MB peak %3 MB, %4 blocks, %5 allocations\n")
+                .arg(MemoryAccounting::tagName(MemoryAccounting::Tag(i)))
+                .arg(usage.bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                .arg(usage.peakBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                .arg(usage.blocks)
+                .arg(usage.allocations);
+    }
+    return text;
+}
+
+void HeadlessRunner::onFeedTimer()
+{
+    if (m_clock.elapsed() >= m_options.durationMs) {
+        m_feedTimer.stop();
+        m_memoryTimer.stop();
+        onMemoryTimer();
+        m_elapsedMs = m_clock.elapsed();
+        emit finished();
+        return;
+    }
+
+    MarketData data;
+    if (m_feed.isEmpty()) {
+        data = m_provider.generateSimulatedData();
+    } else {
+        // 与网络回复相同的处理，文件读完后从头回放；格式错误的行跳过
+        TickStamps stamps;
+        stamps.received = TickStamps::now();
+        bool ok = m_provider.parseMarketData(m_feed[m_feedPosition], &data);
+        m_feedPosition = (m_feedPosition + 1) % m_feed.size();
+        if (!ok) {
+            return;
+        }
+        stamps.decoded = TickStamps::now();
+        data.setTickStamps(stamps);
+    }
+
+    m_updates++;
+    m_stockUpdates += data.getAllStocks().size();
+    m_dataManager.updateMarketData(data);
+}
+
+void HeadlessRunner::onMarketDataUpdated(const MarketData& data)
+{
+    m_model.setMarketData(data);
+    m_latencyMonitor.recordUpdate(data.getTickStamps());
+
+    // 离屏绘制时才有绘制和全程延迟
+    if (m_table) {
+        m_table->render(&m_frame);
+        m_latencyMonitor.recordPaint();
+    }
+}
+
+void HeadlessRunner::onMemoryTimer()
+{
+    // 行情数据的内存只在采样时重新估算
+    m_dataManager.updateMemoryCharge();
+    m_peakResident = qMax(m_peakResident, MemoryAccounting::residentMemory());
+}
+
+QMap<QString, QString> makeSimulatedStocks(int count)
+{
+    static const char *const kPrefixes[] = {"60", "00", "30", "68"};
+
+    QMap<QString, QString> stocks;
+    for (int i = 0; i < count; ++i) {
+        QString code = QString("%1%2").arg(kPrefixes[i % 4]).arg(i / 4, 4, 10, QChar('0'));
+        stocks.insert(code, QString("股票%1").arg(i));
+    }
+    return stocks;
+}
\ No newline at end of file
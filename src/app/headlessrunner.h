@@ -0,0 +1,106 @@
+#pragma once
+
+#include "latencymonitor.h"
+#include "../data/datamanager.h"
+#include "../network/dataprovider.h"
+#include "../ui/quotemodel.h"
+#include "../ui/stocktable.h"
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QVector>
+#include <QByteArray>
+#include <QMap>
+
+/**
+ * @brief 无界面的行情管线压测
+ *
+ * 不创建主窗口，直接把DataProvider（模拟数据或录制的行情文件）、DataManager和
+ * 共享的QuoteModel串起来尽快推送行情，可选地把表格离屏绘制到图像上。
+ * 结束后报告持续的每秒推送数、各阶段延迟分位数和内存占用，用于没有显示器的构建机上做容量测试
+ */
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 运行参数
+     */
+    struct Options {
+        int symbols = 1000;      // 模拟的股票数量
+        int durationMs = 10000;  // 运行时长（毫秒）
+        int intervalMs = 0;      // 两次推送的间隔（毫秒），0表示尽快推送
+        QString feedFile;        // 录制的行情文件（每行一个JSON行情包），为空时使用模拟数据
+        bool render = false;     // 每次推送后是否离屏绘制表格
+    };
+
+public:
+    explicit HeadlessRunner(const Options& options, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    /**
+     * @brief 开始推送
+     * @return 行情文件无法读取或为空时返回false
+     */
+    bool start();
+
+    /**
+     * @brief 运行结果
+     * @param json 是否输出为JSON
+     */
+    QString report(bool json) const;
+
+signals:
+    /**
+     * @brief 运行结束信号
+     */
+    void finished();
+
+private slots:
+    /**
+     * @brief 推送一次行情
+     */
+    void onFeedTimer();
+
+    /**
+     * @brief 数据管理器更新后刷新模型，按需离屏绘制
+     * @param data 更新后的市场数据
+     */
+    void onMarketDataUpdated(const MarketData& data);
+
+    /**
+     * @brief 采样进程内存
+     */
+    void onMemoryTimer();
+
+private:
+    Options m_options;                 // 运行参数
+    DataProvider m_provider;           // 行情来源
+    DataManager m_dataManager;         // 数据管理器
+    QuoteModel m_model;                // 行情表格模型
+    StockTable *m_table;               // 离屏绘制的表格，不绘制时为nullptr
+    QImage m_frame;                    // 离屏绘制目标
+    LatencyMonitor m_latencyMonitor;   // 各阶段延迟
+
+    QVector<QByteArray> m_feed;        // 录制的行情包
+    int m_feedPosition;                // 下一个要回放的行情包
+
+    QTimer m_feedTimer;                // 推送定时器
+    QTimer m_memoryTimer;              // 内存采样定时器
+    QElapsedTimer m_clock;             // 运行计时
+    qint64 m_elapsedMs;                // 实际运行时长（毫秒）
+    quint64 m_updates;                 // 推送次数
+    quint64 m_stockUpdates;            // 推送的股票条数
+    qint64 m_peakResident;             // 进程常驻内存峰值
+};
+
+/**
+ * @brief 生成指定数量的模拟股票列表，代码依次分布在沪市、深市、创业板和科创板
+ *
+ * 供压测和基准测试按规模生成股票
+ * @param count 股票数量
+ * @return 股票代码到名称的映射
+ */
+QMap<QString, QString> makeSimulatedStocks(int count);
\ No newline at end of file
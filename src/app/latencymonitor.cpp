@@ -0,0 +1,145 @@
+#include "latencymonitor.h"
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QDebug>
+
+LatencyMonitor::LatencyMonitor(QObject *parent)
+    : QObject(parent)
+    , m_lastReceived(0)
+    , m_pendingReceived(0)
+    , m_pendingUpdated(0)
+    , m_dumpedCount(0)
+{
+    connect(&m_dumpTimer, &QTimer::timeout, this, &LatencyMonitor::dump);
+}
+
+LatencyMonitor::~LatencyMonitor()
+{
+    // 退出前写入最后一段统计
+    dump();
+}
+
+void LatencyMonitor::recordUpdate(const TickStamps& stamps)
+{
+    if (stamps.received == 0 || stamps.received == m_lastReceived) {
+        return;
+    }
+    m_lastReceived = stamps.received;
+
+    qint64 updated = TickStamps::now();
+    record(DecodeStage, stamps.received, stamps.decoded);
+    record(ApplyStage, stamps.decoded, stamps.applied);
+    record(ModelStage, stamps.applied, updated);
+
+    m_pendingReceived = stamps.received;
+    m_pendingUpdated = updated;
+}
+
+void LatencyMonitor::recordPaint()
+{
+    if (m_pendingReceived == 0) {
+        return;
+    }
+
+    qint64 painted = TickStamps::now();
+    record(PaintStage, m_pendingUpdated, painted);
+    record(TotalStage, m_pendingReceived, painted);
+
+    m_pendingReceived = 0;
+    m_pendingUpdated = 0;
+}
+
+QString LatencyMonitor::stageName(Stage stage)
+{
+    switch (stage) {
+    case DecodeStage:
+        return "decode";
+    case ApplyStage:
+        return "apply";
+    case ModelStage:
+        return "model";
+    case PaintStage:
+        return "paint";
+    case TotalStage:
+        return "total";
+    case StageCount:
+        break;
+    }
+    return QString();
+}
+
+QString LatencyMonitor::summary() const
+{
+    QString text;
+    QTextStream stream(&text);
+
+    for (int i = 0; i < StageCount; ++i) {
+        const LatencyHistogram& histogram = m_histograms[i];
+        stream << QString("%1 count=%2 p50=%3us p99=%4us p99.9=%5us max=%6us\n")
+                  .arg(stageName(Stage(i)), -6)
+                  .arg(histogram.count())
+                  .arg(histogram.percentile(50.0))
+                  .arg(histogram.percentile(99.0))
+                  .arg(histogram.percentile(99.9))
+                  .arg(histogram.max());
+    }
+
+    return text;
+}
+
+void LatencyMonitor::setLogFile(const QString& path)
+{
+    m_logFile = path;
+}
+
+void LatencyMonitor::setDumpInterval(int msecs)
+{
+    if (msecs > 0) {
+        m_dumpTimer.start(msecs);
+    } else {
+        m_dumpTimer.stop();
+    }
+}
+
+void LatencyMonitor::reset()
+{
+    for (LatencyHistogram& histogram : m_histograms) {
+        histogram.reset();
+    }
+
+    m_lastReceived = 0;
+    m_pendingReceived = 0;
+    m_pendingUpdated = 0;
+    m_dumpedCount = 0;
+}
+
+void LatencyMonitor::dump()
+{
+    quint64 count = m_histograms[TotalStage].count();
+    if (m_logFile.isEmpty() || count == m_dumpedCount) {
+        return;
+    }
+
+    QFile file(m_logFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Cannot open latency log:" << m_logFile << file.errorString();
+        return;
+    }
+
+    QTextStream stream(&file);
+    stream << "# " << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << "\n"
+           << summary();
+
+    m_dumpedCount = count;
+}
+
+void LatencyMonitor::record(Stage stage, qint64 from, qint64 to)
+{
+    if (from == 0 || to == 0) {
+        return;
+    }
+
+    // 时间戳为纳秒，直方图以微秒计
+    m_histograms[stage].record((to - from) / 1000);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../data/latencyhistogram.h"
+#include "../data/marketdata.h"
+#include <QObject>
+#include <QTimer>
+#include <QString>
+
+/**
+ * @brief 行情延迟统计
+ *
+ * 根据行情携带的时间戳统计从收到数据到画面更新的各阶段延迟：
+ * 解析、写入数据管理器、表格模型和图表更新（含等待下一帧的时间）、绘制，以及全程。
+ * 每个阶段一个HDR直方图，可以随时查询分位数，并定期追加写入日志文件
+ */
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 统计阶段
+     */
+    enum Stage {
+        DecodeStage,    // 收到 -> 解析完成
+        ApplyStage,     // 解析完成 -> 写入数据管理器
+        ModelStage,     // 写入 -> 表格模型和图表更新
+        PaintStage,     // 模型更新 -> 绘制完成
+        TotalStage,     // 收到 -> 绘制完成
+        StageCount
+    };
+
+public:
+    explicit LatencyMonitor(QObject *parent = nullptr);
+    ~LatencyMonitor();
+
+    /**
+     * @brief 记录一次行情的模型更新，之后的第一次绘制记为它的绘制完成
+     *
+     * 同一次行情只统计一次，被后续行情合并掉的行情不统计
+     * @param stamps 行情的时间戳
+     */
+    void recordUpdate(const TickStamps& stamps);
+
+    /**
+     * @brief 记录绘制完成
+     */
+    void recordPaint();
+
+    /**
+     * @brief 获取阶段的延迟直方图（微秒）
+     * @param stage 阶段
+     */
+    const LatencyHistogram& histogram(Stage stage) const { return m_histograms[stage]; }
+
+    /**
+     * @brief 阶段名称，用于日志
+     */
+    static QString stageName(Stage stage);
+
+    /**
+     * @brief 各阶段的样本数和p50/p99/p99.9/最大延迟，每个阶段一行
+     */
+    QString summary() const;
+
+    /**
+     * @brief 设置日志文件，为空时不写日志
+     * @param path 文件路径
+     */
+    void setLogFile(const QString& path);
+
+    /**
+     * @brief 设置写日志的间隔
+     * @param msecs 间隔（毫秒），为0时停止定期写日志
+     */
+    void setDumpInterval(int msecs);
+
+    /**
+     * @brief 清空统计
+     */
+    void reset();
+
+public slots:
+    /**
+     * @brief 把当前统计追加写入日志文件，上次写入后没有新样本时跳过
+     */
+    void dump();
+
+private:
+    /**
+     * @brief 记录两个时间戳之间的延迟，任一时间戳缺失时跳过
+     */
+    void record(Stage stage, qint64 from, qint64 to);
+
+private:
+    LatencyHistogram m_histograms[StageCount];  // 各阶段延迟
+
+    qint64 m_lastReceived;      // 最近统计过的行情的收到时间
+    qint64 m_pendingReceived;   // 等待绘制的行情的收到时间，0表示没有
+    qint64 m_pendingUpdated;    // 等待绘制的行情的模型更新时间
+
+    QString m_logFile;          // 日志文件
+    QTimer m_dumpTimer;         // 写日志定时器
+    quint64 m_dumpedCount;      // 上次写日志时的全程样本数
+};
\ No newline at end of file
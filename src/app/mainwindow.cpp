@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "../data/tracer.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
@@ -7,6 +8,13 @@
 #include <QTimer>
 #include <QMessageBox>
 #include <QSplitter>
+#include <QKeyEvent>
+#include <QWindow>
+#include <QMenu>
+#include <QToolButton>
+#include <QScrollArea>
+#include <QElapsedTimer>
+#include <QFileDialog>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -14,10 +22,18 @@ MainWindow::MainWindow(QWidget *parent)
     , m_tabWidget(nullptr)
     , m_stockTable(nullptr)
     , m_quoteChart(nullptr)
+    , m_symbolSearch(nullptr)
+    , m_quoteModel(nullptr)
+    , m_dataManager(nullptr)
+    , m_chartSubscription(0)
+    , m_tableSubscription(0)
     , m_toolBar(nullptr)
     , m_stockTypeCombo(nullptr)
     , m_statusLabel(nullptr)
     , m_timeLabel(nullptr)
+    , m_performancePanel(nullptr)
+    , m_frameScheduler(nullptr)
+    , m_latencyMonitor(nullptr)
 {
     setWindowTitle(tr("证券行情客户端"));
     resize(1024, 768);
@@ -26,6 +42,10 @@ MainWindow::MainWindow(QWidget *parent)
     createToolBar();
     createStatusBar();
     
+    // 数据更新只标记脏区域，由帧调度器每帧统一重绘
+    m_frameScheduler = new FrameScheduler(this);
+    connect(m_frameScheduler, &FrameScheduler::frameRequested, this, &MainWindow::renderFrame);
+    
     // 更新时间
     QTimer *timer = new QTimer(this);
     connect(timer, &QTimer::timeout, [this]() {
@@ -39,6 +59,40 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+void MainWindow::setDataManager(DataManager* dataManager)
+{
+    m_dataManager = dataManager;
+    m_quoteChart->setKLineHistory(m_dataManager->kLineHistory());
+    m_quoteChart->setIntradayHistory(m_dataManager->intradayHistory());
+    
+    // 主图表订阅当前选中的股票，其他股票的变化不会唤醒图表
+    QStringList codes;
+    if (!m_currentStockCode.isEmpty()) {
+        codes << m_currentStockCode;
+    }
+    
+    m_chartSubscription = m_dataManager->subscribe(codes, DataManager::AllFields, this,
+        [this](const QVector<DataManager::StockUpdate>&) {
+            markChartDirty(m_quoteChart);
+        });
+    
+    // 行情表只通知价格和成交变化的单元格，股票集合变化时模型重置并重新订阅
+    m_tableSubscription = m_dataManager->subscribe(m_quoteModel->getMarketData().getAllStocks().keys(),
+        DataManager::PriceField | DataManager::VolumeField, m_quoteModel,
+        [this](const QVector<DataManager::StockUpdate>& updates) {
+            m_quoteModel->markChanged(updates);
+            m_frameScheduler->markDirty(FrameScheduler::TableRegion);
+        });
+    connect(m_quoteModel, &QAbstractItemModel::modelReset, this, [this]() {
+        m_dataManager->setSubscriptionCodes(m_tableSubscription, m_quoteModel->getMarketData().getAllStocks().keys());
+    });
+}
+
+void MainWindow::setLatencyMonitor(LatencyMonitor* monitor)
+{
+    m_latencyMonitor = monitor;
+}
+
 void MainWindow::setupUi()
 {
     // 创建中央小部件
@@ -52,8 +106,9 @@ void MainWindow::setupUi()
     QSplitter *splitter = new QSplitter(Qt::Vertical);
     mainLayout->addWidget(splitter);
     
-    // 创建股票表格
-    m_stockTable = new StockTable();
+    // 创建所有看板共享的行情模型和主看板
+    m_quoteModel = new QuoteModel(this);
+    m_stockTable = createBoard();
     splitter->addWidget(m_stockTable);
     
     // 创建行情图表区域
@@ -64,13 +119,204 @@ void MainWindow::setupUi()
     m_quoteChart = new QuoteChart();
     chartLayout->addWidget(m_quoteChart);
     
+    // 切换图表类型或周期时用最新数据重绘
+    connect(m_quoteChart, &QuoteChart::stockChanged, this, [this]() {
+        markChartDirty(m_quoteChart);
+    });
+    
     splitter->addWidget(chartWidget);
     
     // 设置初始分割比例
     splitter->setSizes(QList<int>() << 300 << 400);
     
-    // 连接股票选择信号
-    connect(m_stockTable, &StockTable::stockSelected, this, &MainWindow::onStockSelected);
+    // 创建键盘精灵，选中结果直接切换当前股票
+    m_symbolSearch = new SymbolSearch(this);
+    connect(m_symbolSearch, &SymbolSearch::stockChosen, this, &MainWindow::onStockSelected);
+}
+
+StockTable* MainWindow::createBoard()
+{
+    StockTable *board = new StockTable(m_quoteModel);
+    
+    connect(board, &StockTable::stockSelected, this, &MainWindow::onStockSelected);
+    connect(board, &StockTable::symbolSearchRequested, this, &MainWindow::openSymbolSearch);
+    connect(board, &StockTable::addToWatchlistRequested, this, &MainWindow::addToWatchlist);
+    connect(board, &StockTable::removeFromWatchlistRequested, this, &MainWindow::removeFromWatchlist);
+    
+    return board;
+}
+
+void MainWindow::applyBoardType(StockTable* board, BoardType type)
+{
+    switch (type) {
+    case BoardType::All:
+        board->clearFilter();
+        break;
+    case BoardType::ShanghaiA:
+        board->setMarketTypeFilter(StockItem::MarketType::ShanghaiA);
+        break;
+    case BoardType::ShenzhenA:
+        board->setMarketTypeFilter(StockItem::MarketType::ShenzhenA);
+        break;
+    case BoardType::ChiNext:
+        board->setMarketTypeFilter(StockItem::MarketType::ChiNext);
+        break;
+    case BoardType::StarMarket:
+        board->setMarketTypeFilter(StockItem::MarketType::StarMarket);
+        break;
+    case BoardType::Gainers:
+        board->sortByColumn(QuoteModel::ColChangePercent, Qt::DescendingOrder);
+        break;
+    case BoardType::Losers:
+        board->sortByColumn(QuoteModel::ColChangePercent, Qt::AscendingOrder);
+        break;
+    case BoardType::Watchlist:
+        board->setCodeFilter(m_watchlist);
+        break;
+    }
+}
+
+void MainWindow::addBoard(BoardType type)
+{
+    static const QMap<BoardType, QString> titles = {
+        {BoardType::All, tr("全部")},
+        {BoardType::ShanghaiA, tr("上证A股")},
+        {BoardType::ShenzhenA, tr("深证A股")},
+        {BoardType::ChiNext, tr("创业板")},
+        {BoardType::StarMarket, tr("科创板")},
+        {BoardType::Gainers, tr("涨幅榜")},
+        {BoardType::Losers, tr("跌幅榜")},
+        {BoardType::Watchlist, tr("自选股")}
+    };
+    
+    // 新看板只是共享模型上的一个视图，不复制行情数据
+    StockTable *board = createBoard();
+    applyBoardType(board, type);
+    
+    m_boards.append(board);
+    if (type == BoardType::Watchlist) {
+        m_watchlistBoards.append(board);
+    }
+    
+    connect(board, &QObject::destroyed, this, [this, board]() {
+        m_boards.removeOne(board);
+        m_watchlistBoards.removeOne(board);
+    });
+    
+    QDockWidget *dock = new QDockWidget(titles.value(type), this);
+    dock->setAttribute(Qt::WA_DeleteOnClose);
+    dock->setWidget(board);
+    addDockWidget(Qt::RightDockWidgetArea, dock);
+}
+
+void MainWindow::addChartPanel()
+{
+    if (m_currentStockCode.isEmpty()) {
+        m_statusLabel->setText(tr("请先选择股票"));
+        return;
+    }
+    
+    QuoteChart *chart = new QuoteChart();
+    m_chartPanels.append(chart);
+    
+    connect(chart, &QObject::destroyed, this, [this, chart]() {
+        m_chartPanels.removeOne(chart);
+        m_dirtyCharts.remove(chart);
+    });
+    connect(chart, &QuoteChart::stockChanged, this, [this, chart]() {
+        markChartDirty(chart);
+    });
+    
+    // 图表面板订阅固定显示的股票，随面板销毁自动取消订阅
+    if (m_dataManager) {
+        chart->setKLineHistory(m_dataManager->kLineHistory());
+        chart->setIntradayHistory(m_dataManager->intradayHistory());
+        m_dataManager->subscribe(QStringList() << m_currentStockCode, DataManager::AllFields, chart,
+            [this, chart](const QVector<DataManager::StockUpdate>&) {
+                markChartDirty(chart);
+            });
+    }
+    
+    const StockItem *stock = m_marketData.getStock(m_currentStockCode);
+    if (stock) {
+        chart->updateChart(*stock);
+    }
+    
+    QDockWidget *dock = new QDockWidget(m_currentStockCode, this);
+    dock->setAttribute(Qt::WA_DeleteOnClose);
+    dock->setWidget(chart);
+    addDockWidget(Qt::BottomDockWidgetArea, dock);
+}
+
+void MainWindow::addSparklineGrid()
+{
+    QStringList codes = m_watchlist.isEmpty() ? m_marketData.getAllStockCodes() : m_watchlist.values();
+    codes.sort();
+    
+    SparklineGrid *grid = new SparklineGrid();
+    grid->setCodes(codes);
+    m_sparklineGrids.append(grid);
+    
+    connect(grid, &QObject::destroyed, this, [this, grid]() {
+        m_sparklineGrids.removeOne(grid);
+    });
+    connect(grid, &SparklineGrid::stockSelected, this, &MainWindow::onStockSelected);
+    
+    // 网格只记录变化的股票，下一帧统一重新计算这些单元格
+    if (m_dataManager) {
+        m_dataManager->subscribe(codes, DataManager::PriceField | DataManager::TimeSeriesField, grid,
+            [this, grid](const QVector<DataManager::StockUpdate>& updates) {
+                QStringList changed;
+                changed.reserve(updates.size());
+                for (const DataManager::StockUpdate& update : updates) {
+                    changed.append(update.code);
+                }
+                grid->markChanged(changed);
+                m_frameScheduler->markDirty(FrameScheduler::ChartRegion);
+            });
+    }
+    grid->refresh(m_marketData);
+    
+    QScrollArea *scrollArea = new QScrollArea();
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    scrollArea->setWidget(grid);
+    
+    QDockWidget *dock = new QDockWidget(tr("走势网格"), this);
+    dock->setAttribute(Qt::WA_DeleteOnClose);
+    dock->setWidget(scrollArea);
+    addDockWidget(Qt::BottomDockWidgetArea, dock);
+}
+
+void MainWindow::onStockTypeChanged(int index)
+{
+    static const BoardType types[] = {
+        BoardType::All,
+        BoardType::ShanghaiA,
+        BoardType::ShenzhenA,
+        BoardType::ChiNext,
+        BoardType::StarMarket
+    };
+    
+    if (index >= 0 && index < int(sizeof(types) / sizeof(types[0]))) {
+        applyBoardType(m_stockTable, types[index]);
+    }
+}
+
+void MainWindow::addToWatchlist(const QString& code)
+{
+    m_watchlist.insert(code);
+    for (StockTable *board : m_watchlistBoards) {
+        board->setCodeFilter(m_watchlist);
+    }
+}
+
+void MainWindow::removeFromWatchlist(const QString& code)
+{
+    m_watchlist.remove(code);
+    for (StockTable *board : m_watchlistBoards) {
+        board->setCodeFilter(m_watchlist);
+    }
 }
 
 void MainWindow::createToolBar()
@@ -95,6 +341,34 @@ void MainWindow::createToolBar()
     m_stockTypeCombo->addItem(tr("创业板"));
     m_stockTypeCombo->addItem(tr("科创板"));
     m_toolBar->addWidget(m_stockTypeCombo);
+    connect(m_stockTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onStockTypeChanged);
+    
+    m_toolBar->addSeparator();
+    
+    // 添加新建看板菜单
+    QMenu *boardMenu = new QMenu(this);
+    boardMenu->addAction(tr("全部"), this, [this]() { addBoard(BoardType::All); });
+    boardMenu->addAction(tr("上证A股"), this, [this]() { addBoard(BoardType::ShanghaiA); });
+    boardMenu->addAction(tr("深证A股"), this, [this]() { addBoard(BoardType::ShenzhenA); });
+    boardMenu->addAction(tr("创业板"), this, [this]() { addBoard(BoardType::ChiNext); });
+    boardMenu->addAction(tr("科创板"), this, [this]() { addBoard(BoardType::StarMarket); });
+    boardMenu->addSeparator();
+    boardMenu->addAction(tr("涨幅榜"), this, [this]() { addBoard(BoardType::Gainers); });
+    boardMenu->addAction(tr("跌幅榜"), this, [this]() { addBoard(BoardType::Losers); });
+    boardMenu->addAction(tr("自选股"), this, [this]() { addBoard(BoardType::Watchlist); });
+    
+    QToolButton *boardButton = new QToolButton();
+    boardButton->setText(tr("新建看板"));
+    boardButton->setMenu(boardMenu);
+    boardButton->setPopupMode(QToolButton::InstantPopup);
+    m_toolBar->addWidget(boardButton);
+    
+    QAction *chartPanelAction = m_toolBar->addAction(tr("新建图表"));
+    connect(chartPanelAction, &QAction::triggered, this, &MainWindow::addChartPanel);
+    
+    QAction *sparklineGridAction = m_toolBar->addAction(tr("走势网格"));
+    connect(sparklineGridAction, &QAction::triggered, this, &MainWindow::addSparklineGrid);
     
     m_toolBar->addSeparator();
     
@@ -104,6 +378,21 @@ void MainWindow::createToolBar()
     
     QAction *candlestickAction = m_toolBar->addAction(tr("K线图"));
     connect(candlestickAction, &QAction::triggered, this, &MainWindow::showCandlestickChart);
+    
+    m_toolBar->addSeparator();
+    
+    // 状态栏中的性能面板
+    QAction *performanceAction = m_toolBar->addAction(tr("性能"));
+    performanceAction->setCheckable(true);
+    connect(performanceAction, &QAction::toggled, this, [this](bool checked) {
+        m_performancePanel->setVisible(checked);
+    });
+    
+#ifdef QUOTECLIENT_TRACING
+    // 导出各线程最近的跟踪记录，用Perfetto打开
+    QAction *traceAction = m_toolBar->addAction(tr("导出跟踪"));
+    connect(traceAction, &QAction::triggered, this, &MainWindow::exportTrace);
+#endif
 }
 
 void MainWindow::createStatusBar()
@@ -111,26 +400,67 @@ void MainWindow::createStatusBar()
     m_statusLabel = new QLabel(tr("就绪"));
     statusBar()->addWidget(m_statusLabel);
     
+    m_performancePanel = new PerformancePanel();
+    m_performancePanel->setSampler([this]() { return samplePerformance(); });
+    m_performancePanel->hide();
+    statusBar()->addPermanentWidget(m_performancePanel);
+    
     m_timeLabel = new QLabel();
     statusBar()->addPermanentWidget(m_timeLabel);
 }
 
 void MainWindow::updateUI(const MarketData& marketData)
 {
-    // 更新股票表格
-    m_stockTable->updateData(marketData);
+    // 保存最新数据（隐式共享，不复制股票数据）
+    m_marketData = marketData;
     
-    // 如果有选中的股票，则更新图表
-    if (!m_currentStockCode.isEmpty()) {
-        const StockItem *stock = marketData.getStock(m_currentStockCode);
-        if (stock) {
-            m_quoteChart->updateChart(*stock);
+    // 股票集合变化时重建键盘精灵索引
+    m_symbolSearch->setMarketData(marketData);
+    
+    // 图表由订阅回调单独标记
+    m_frameScheduler->markDirty(FrameScheduler::TableRegion | FrameScheduler::StatusRegion);
+}
+
+void MainWindow::renderFrame(FrameScheduler::Regions regions)
+{
+    TRACE_SCOPE("MainWindow::renderFrame");
+    QElapsedTimer timer;
+    
+    // 更新共享的行情模型，所有看板只重绘各自可见的单元格
+    if (regions & FrameScheduler::TableRegion) {
+        timer.start();
+        m_quoteModel->setMarketData(m_marketData);
+        m_tableFrameTimes.record(timer.nsecsElapsed() / 1000);
+    }
+    
+    // 只更新所显示股票发生变化的图表
+    if (regions & FrameScheduler::ChartRegion) {
+        timer.start();
+        for (QuoteChart *chart : std::as_const(m_dirtyCharts)) {
+            QString code = (chart == m_quoteChart) ? m_currentStockCode : chart->getStockCode();
+            const StockItem *stock = m_marketData.getStock(code);
+            if (stock) {
+                chart->updateChart(*stock);
+            }
+        }
+        m_dirtyCharts.clear();
+        
+        for (SparklineGrid *grid : std::as_const(m_sparklineGrids)) {
+            grid->refresh(m_marketData);
         }
+        m_chartFrameTimes.record(timer.nsecsElapsed() / 1000);
     }
     
     // 更新状态栏
-    m_statusLabel->setText(tr("数据已更新 - %1")
-                          .arg(QDateTime::currentDateTime().toString("hh:mm:ss")));
+    if (regions & FrameScheduler::StatusRegion) {
+        m_statusLabel->setText(tr("数据已更新 - %1")
+                              .arg(m_marketData.getUpdateTime().toString("hh:mm:ss")));
+    }
+    
+    // 模型和图表已更新，等待本帧绘制
+    if (m_latencyMonitor) {
+        m_latencyMonitor->recordUpdate(m_marketData.getTickStamps());
+    }
 }
 
 void MainWindow::onStockSelected(const QString& code)
@@ -138,6 +468,12 @@ void MainWindow::onStockSelected(const QString& code)
     m_currentStockCode = code;
     // 当选择了新股票时，通知其他组件
     emit m_quoteChart->stockChanged(code);
+    
+    // 主图表改为订阅新股票，下一帧用最新数据绘制
+    if (m_dataManager) {
+        m_dataManager->setSubscriptionCodes(m_chartSubscription, QStringList() << code);
+    }
+    markChartDirty(m_quoteChart);
 }
 
 void MainWindow::showTimeSeriesChart()
@@ -150,8 +486,148 @@ void MainWindow::showCandlestickChart()
     m_quoteChart->setChartType(QuoteChart::ChartType::Candlestick);
 }
 
+void MainWindow::openSymbolSearch(const QString& text)
+{
+    m_symbolSearch->popup(text);
+}
+
+bool MainWindow::event(QEvent *event)
+{
+    // 顶层窗口在处理UpdateRequest时同步绘制所有脏控件并刷新到屏幕
+    bool handled = QMainWindow::event(event);
+    if (event->type() == QEvent::UpdateRequest && m_latencyMonitor) {
+        m_latencyMonitor->recordPaint();
+    }
+    
+    return handled;
+}
+
+void MainWindow::keyPressEvent(QKeyEvent *event)
+{
+    QString text = event->text();
+    if (text.size() == 1 && text.at(0).unicode() < 128 && text.at(0).isLetterOrNumber()
+        && !(event->modifiers() & (Qt::ControlModifier | Qt::AltModifier))) {
+        openSymbolSearch(text);
+        return;
+    }
+    
+    QMainWindow::keyPressEvent(event);
+}
+
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::WindowStateChange) {
+        updateRenderingPaused();
+    }
+    
+    QMainWindow::changeEvent(event);
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    
+    // 原生窗口在首次显示时才创建
+    if (QWindow *window = windowHandle()) {
+        window->removeEventFilter(this);
+        window->installEventFilter(this);
+    }
+    
+    updateRenderingPaused();
+}
+
+void MainWindow::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateRenderingPaused();
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == windowHandle() && event->type() == QEvent::Expose) {
+        updateRenderingPaused();
+    }
+    
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::markChartDirty(QuoteChart* chart)
+{
+    m_dirtyCharts.insert(chart);
+    m_frameScheduler->markDirty(FrameScheduler::ChartRegion);
+}
+
+void MainWindow::exportTrace()
+{
+    QString path = QFileDialog::getSaveFileName(this, tr("导出跟踪"),
+                                                QString("quoteclient-trace-%1.json")
+                                                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")),
+                                                tr("Chrome trace (*.json)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    if (Tracer::exportChromeTrace(path)) {
+        m_statusLabel->setText(tr("跟踪已导出 - %1").arg(path));
+    } else {
+        QMessageBox::warning(this, tr("导出跟踪"), tr("无法写入文件：%1").arg(path));
+    }
+}
+
+PerformanceSample MainWindow::samplePerformance() const
+{
+    PerformanceSample sample;
+    
+    if (m_dataManager) {
+        sample.updatesReceived = m_dataManager->updateCount();
+        sample.pendingDeliveries = m_dataManager->pendingDeliveries();
+    }
+    
+    if (m_latencyMonitor) {
+        const LatencyHistogram& decode = m_latencyMonitor->histogram(LatencyMonitor::DecodeStage);
+        sample.updatesRendered = m_latencyMonitor->histogram(LatencyMonitor::ModelStage).count();
+        sample.parseCount = decode.count();
+        sample.parseMicros = decode.sum();
+    }
+    
+    sample.tableFrames = m_tableFrameTimes.count();
+    sample.tableMicros = m_tableFrameTimes.sum();
+    sample.chartFrames = m_chartFrameTimes.count();
+    sample.chartMicros = m_chartFrameTimes.sum();
+    sample.dirtyCharts = m_dirtyCharts.size();
+    
+    // 行情数据的内存只在采样时重新估算
+    if (m_dataManager) {
+        m_dataManager->updateMemoryCharge();
+    }
+    for (int i = 0; i < MemoryAccounting::TagCount; ++i) {
+        sample.memory[i] = MemoryAccounting::usage(MemoryAccounting::Tag(i));
+    }
+    sample.residentBytes = MemoryAccounting::residentMemory();
+    
+    return sample;
+}
+
+void MainWindow::updateRenderingPaused()
+{
+    if (!m_frameScheduler) {
+        return;
+    }
+    
+    // 最小化、隐藏或被完全遮挡（平台支持时isExposed为false）时不再重绘
+    bool paused = isMinimized() || !isVisible();
+    if (QWindow *window = windowHandle()) {
+        paused = paused || !window->isExposed();
+    }
+    
+    m_frameScheduler->setPaused(paused);
+}
+
 void MainWindow::refreshData()
 {
-    // 仅发出请求刷新的信号，具体刷新逻辑由数据管理层处理
+    // 仅发出请求刷新的信号，具体刷新逻辑由数据管理层处理（休市时同样立即刷新）
     m_statusLabel->setText(tr("正在刷新数据..."));
+    if (m_dataManager) {
+        m_dataManager->requestRefresh();
+    }
 } 
\ No newline at end of file
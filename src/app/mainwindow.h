@@ -1,8 +1,16 @@
 #pragma once
 
 #include "../ui/stocktable.h"
+#include "../ui/quotemodel.h"
 #include "../ui/quotechart.h"
+#include "../ui/sparklinegrid.h"
+#include "../ui/symbolsearch.h"
+#include "../ui/framescheduler.h"
+#include "../ui/performancepanel.h"
+#include "../data/latencyhistogram.h"
+#include "latencymonitor.h"
 #include "../data/marketdata.h"
+#include "../data/datamanager.h"
 
 #include <QMainWindow>
 #include <QTabWidget>
@@ -10,6 +18,9 @@
 #include <QStatusBar>
 #include <QLabel>
 #include <QComboBox>
+#include <QDockWidget>
+#include <QList>
+#include <QSet>
 #include <memory>
 
 namespace Ui {
@@ -25,10 +36,37 @@ class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
+public:
+    /**
+     * @brief 看板类型枚举
+     */
+    enum class BoardType {
+        All,           // 全部
+        ShanghaiA,     // 上证A股
+        ShenzhenA,     // 深证A股
+        ChiNext,       // 创业板
+        StarMarket,    // 科创板
+        Gainers,       // 涨幅榜
+        Losers,        // 跌幅榜
+        Watchlist      // 自选股
+    };
+
 public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    /**
+     * @brief 设置数据管理器，图表通过它订阅所显示股票的变化
+     * @param dataManager 数据管理器
+     */
+    void setDataManager(DataManager* dataManager);
+
+    /**
+     * @brief 设置行情延迟统计，每帧记录模型更新和绘制完成的时间
+     * @param monitor 延迟统计，为nullptr时不统计
+     */
+    void setLatencyMonitor(LatencyMonitor* monitor);
+
 public slots:
     /**
      * @brief 更新UI显示
@@ -58,6 +96,88 @@ private slots:
      */
     void refreshData();
 
+    /**
+     * @brief 打开键盘精灵
+     * @param text 初始输入文本
+     */
+    void openSymbolSearch(const QString& text);
+
+    /**
+     * @brief 重绘一帧
+     * @param regions 需要重绘的区域
+     */
+    void renderFrame(FrameScheduler::Regions regions);
+
+    /**
+     * @brief 新建看板
+     * @param type 看板类型
+     */
+    void addBoard(BoardType type);
+
+    /**
+     * @brief 新建图表面板，固定显示当前选中的股票
+     */
+    void addChartPanel();
+
+    /**
+     * @brief 新建分时走势网格，显示自选股（没有自选股时显示全部股票）
+     */
+    void addSparklineGrid();
+
+    /**
+     * @brief 工具栏股票类型变化，过滤主看板
+     * @param index 下拉框索引
+     */
+    void onStockTypeChanged(int index);
+
+    /**
+     * @brief 加入自选股
+     * @param code 股票代码
+     */
+    void addToWatchlist(const QString& code);
+
+    /**
+     * @brief 移出自选股
+     * @param code 股票代码
+     */
+    void removeFromWatchlist(const QString& code);
+
+protected:
+    /**
+     * @brief 窗口完成一次重绘（UpdateRequest）后记录绘制完成时间
+     * @param event 事件对象
+     */
+    bool event(QEvent *event) override;
+
+    /**
+     * @brief 处理按键事件，输入字母或数字时打开键盘精灵
+     * @param event 事件对象
+     */
+    void keyPressEvent(QKeyEvent *event) override;
+
+    /**
+     * @brief 窗口状态变化（最小化/还原）时暂停或恢复重绘
+     * @param event 事件对象
+     */
+    void changeEvent(QEvent *event) override;
+
+    /**
+     * @brief 窗口显示时开始跟踪窗口的遮挡状态
+     * @param event 事件对象
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * @brief 窗口隐藏时暂停重绘
+     * @param event 事件对象
+     */
+    void hideEvent(QHideEvent *event) override;
+
+    /**
+     * @brief 监听原生窗口的曝光事件，窗口被完全遮挡时暂停重绘
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
     /**
      * @brief 初始化UI组件
@@ -74,13 +194,67 @@ private:
      */
     void createStatusBar();
 
+    /**
+     * @brief 创建看板表格并连接信号
+     * @return 看板表格
+     */
+    StockTable* createBoard();
+
+    /**
+     * @brief 按看板类型设置看板的过滤和排序
+     * @param board 看板表格
+     * @param type 看板类型
+     */
+    void applyBoardType(StockTable* board, BoardType type);
+
+    /**
+     * @brief 根据窗口可见性更新帧调度器的暂停状态
+     */
+    void updateRenderingPaused();
+
+    /**
+     * @brief 标记图表需要在下一帧重绘
+     * @param chart 图表
+     */
+    void markChartDirty(QuoteChart* chart);
+
+    /**
+     * @brief 把性能跟踪记录导出为Chrome trace文件（需以QUOTECLIENT_TRACING构建）
+     */
+    void exportTrace();
+
+    /**
+     * @brief 采集性能面板所需的计数器
+     * @return 当前采样
+     */
+    PerformanceSample samplePerformance() const;
+
 private:
     Ui::MainWindow *ui;
 
     // UI 组件
     QTabWidget* m_tabWidget;
-    StockTable* m_stockTable;
-    QuoteChart* m_quoteChart;
+    StockTable* m_stockTable;           // 主看板
+    QuoteChart* m_quoteChart;           // 主图表（跟随选中的股票）
+    SymbolSearch* m_symbolSearch;
+    
+    // 所有看板共享的行情模型
+    QuoteModel* m_quoteModel;
+    
+    // 新建的看板和图表面板
+    QList<StockTable*> m_boards;
+    QList<StockTable*> m_watchlistBoards;
+    QList<QuoteChart*> m_chartPanels;
+    QList<SparklineGrid*> m_sparklineGrids;
+    
+    // 图表只订阅所显示股票的变化
+    DataManager* m_dataManager;
+    int m_chartSubscription;            // 主图表的订阅编号
+    int m_tableSubscription;            // 行情表的订阅编号
+    QSet<QuoteChart*> m_dirtyCharts;    // 下一帧需要重绘的图表
+    
+    // 自选股
+    QSet<QString> m_watchlist;
     
     // 工具栏组件
     QToolBar* m_toolBar;
@@ -89,7 +263,15 @@ private:
     // 状态栏组件
     QLabel* m_statusLabel;
     QLabel* m_timeLabel;
+    PerformancePanel* m_performancePanel;  // 性能面板，默认隐藏
     
     // 当前选中的股票代码
     QString m_currentStockCode;
+    
+    // 最新的市场数据，由帧调度器在下一帧统一绘制
+    MarketData m_marketData;
+    FrameScheduler* m_frameScheduler;
+    LatencyMonitor* m_latencyMonitor;   // 行情延迟统计
+    LatencyHistogram m_tableFrameTimes; // 每帧表格更新耗时（微秒）
+    LatencyHistogram m_chartFrameTimes; // 每帧图表更新耗时（微秒）
 }; 
\ No newline at end of file
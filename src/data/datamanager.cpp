@@ -1,13 +1,27 @@
 #include "datamanager.h"
+#include "tracer.h"
 #include <QDebug>
+#include <QThread>
 
 DataManager::DataManager(QObject *parent)
     : QObject(parent)
+    , m_marketDataCharge(MemoryAccounting::DataStoreTag)
     , m_refreshInterval(5000)  // 默认5秒刷新一次
+    , m_currentInterval(5000)
+    , m_autoRefreshEnabled(false)
+    , m_wasActive(false)
+    , m_activitySeen(false)
+    , m_nextSubscriptionId(1)
+    , m_deliveryScheduled(false)
+    , m_updateCount(0)
 {
-    // 设置自动刷新定时器
+    // 设置自动刷新定时器，每次触发后按交易阶段重新安排
+    m_autoRefreshTimer.setSingleShot(true);
     connect(&m_autoRefreshTimer, &QTimer::timeout,
             this, &DataManager::onAutoRefreshTimer);
+    
+    // 往日分时按交易日历跳过周末和节假日
+    m_intradayHistory.setTradingCalendar(&m_tradingCalendar);
 }
 
 DataManager::~DataManager()
@@ -34,33 +48,149 @@ void DataManager::setRefreshInterval(int msecs)
 {
     if (msecs > 0) {
         m_refreshInterval = msecs;
+        m_currentInterval = msecs;
         
-        // 如果定时器正在运行，则重启
-        if (m_autoRefreshTimer.isActive()) {
-            m_autoRefreshTimer.stop();
-            m_autoRefreshTimer.start(m_refreshInterval);
+        // 如果自动刷新正在运行，则按新间隔重新安排
+        if (m_autoRefreshEnabled) {
+            scheduleAutoRefresh(TradingCalendar::currentTime());
         }
     }
 }
 
 void DataManager::startAutoRefresh()
 {
-    if (!m_autoRefreshTimer.isActive()) {
-        m_autoRefreshTimer.start(m_refreshInterval);
+    if (!m_autoRefreshEnabled) {
+        m_autoRefreshEnabled = true;
+        m_currentInterval = m_refreshInterval;
+        
+        // 交易阶段按上海时间计算，与本机时区无关
+        QDateTime now = TradingCalendar::currentTime();
+        m_wasActive = TradingCalendar::isActive(m_tradingCalendar.phase(now));
+        scheduleAutoRefresh(now);
     }
 }
 
 void DataManager::stopAutoRefresh()
 {
+    m_autoRefreshEnabled = false;
     if (m_autoRefreshTimer.isActive()) {
         m_autoRefreshTimer.stop();
     }
 }
 
+void DataManager::scheduleAutoRefresh(const QDateTime& now)
+{
+    qint64 untilChange = now.msecsTo(m_tradingCalendar.nextPhaseChange(now));
+    
+    // 交易阶段内按当前间隔刷新，休市时一直等到下一个阶段开始（最长一小时后重新核对）
+    qint64 interval = untilChange;
+    if (TradingCalendar::isActive(m_tradingCalendar.phase(now))) {
+        interval = qMin(interval, qint64(m_currentInterval));
+        m_autoRefreshTimer.setTimerType(Qt::CoarseTimer);
+    } else {
+        interval = qMin(interval, qint64(kMaxIdleInterval));
+        m_autoRefreshTimer.setTimerType(Qt::VeryCoarseTimer);
+    }
+    
+    m_autoRefreshTimer.start(int(qMax(interval, qint64(1))));
+}
+
+int DataManager::subscribe(const QStringList& codes, StockFields fields,
+                           QObject *context, SubscriptionCallback callback)
+{
+    int id = m_nextSubscriptionId++;
+    
+    Subscription& subscription = m_subscriptions[id];
+    subscription.fields = fields;
+    subscription.context = context;
+    subscription.callback = std::move(callback);
+    
+    setSubscriptionCodes(id, codes);
+    
+    // 上下文对象销毁时自动取消订阅
+    if (context) {
+        connect(context, &QObject::destroyed, this, [this, id]() {
+            unsubscribe(id);
+        });
+    }
+    
+    return id;
+}
+
+void DataManager::setSubscriptionCodes(int id, const QStringList& codes)
+{
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end()) {
+        return;
+    }
+    
+    // 从旧的股票索引中移除
+    for (const QString& code : std::as_const(it->codes)) {
+        QVector<int>& ids = m_subscribersByCode[code];
+        ids.removeOne(id);
+        if (ids.isEmpty()) {
+            m_subscribersByCode.remove(code);
+        }
+    }
+    
+    it->codes = QSet<QString>(codes.cbegin(), codes.cend());
+    it->pending.clear();
+    
+    for (const QString& code : std::as_const(it->codes)) {
+        m_subscribersByCode[code].append(id);
+    }
+}
+
+void DataManager::unsubscribe(int id)
+{
+    setSubscriptionCodes(id, QStringList());
+    m_subscriptions.remove(id);
+}
+
+void DataManager::updateMemoryCharge()
+{
+    m_marketDataCharge.set(m_marketData.byteSize());
+}
+
 void DataManager::updateMarketData(const MarketData& data)
 {
-    // 更新数据
+    TRACE_SCOPE("DataManager::updateMarketData");
+    m_updateCount.fetch_add(1, std::memory_order_relaxed);
+    
+    // 更新数据，旧数据在比较完成前保持有效
+    MarketData previous = m_marketData;
     m_marketData = data;
+    if (m_marketData.getAllStocks().size() != previous.getAllStocks().size()) {
+        updateMemoryCharge();
+    }
+    m_quoteIndex.update(m_marketData);
+    
+    // 只比较有订阅者的股票
+    for (auto it = m_subscribersByCode.cbegin(); it != m_subscribersByCode.cend(); ++it) {
+        StockFields changed = diffStock(previous.getStock(it.key()), m_marketData.getStock(it.key()));
+        if (changed == NoField) {
+            continue;
+        }
+        m_activitySeen = true;
+        
+        for (int id : it.value()) {
+            Subscription& subscription = m_subscriptions[id];
+            StockFields wanted = changed & subscription.fields;
+            if (wanted != NoField) {
+                subscription.pending[it.key()] |= wanted;
+                
+                if (!m_deliveryScheduled) {
+                    m_deliveryScheduled = true;
+                    QMetaObject::invokeMethod(this, &DataManager::deliverPendingUpdates, Qt::QueuedConnection);
+                }
+            }
+        }
+    }
+    
+    // 记录写入完成的时间
+    TickStamps stamps = m_marketData.getTickStamps();
+    stamps.applied = TickStamps::now();
+    m_marketData.setTickStamps(stamps);
     
     // 发送数据更新信号
     emit marketDataUpdated(m_marketData);
@@ -74,6 +204,118 @@ void DataManager::requestRefresh()
 
 void DataManager::onAutoRefreshTimer()
 {
-    // 定时器触发时请求刷新数据
-    requestRefresh();
+    QDateTime now = TradingCalendar::currentTime();
+    bool active = TradingCalendar::isActive(m_tradingCalendar.phase(now));
+    
+    // 订阅的股票有变化（或没有订阅者）时保持基础间隔，连续没有变化时逐步放慢
+    if (m_activitySeen || m_subscribersByCode.isEmpty()) {
+        m_currentInterval = m_refreshInterval;
+    } else {
+        m_currentInterval = qMin(m_currentInterval * 2, m_refreshInterval * int(kMaxRefreshBackoff));
+    }
+    m_activitySeen = false;
+    
+    // 交易阶段内定时刷新；刚进入午休或收盘时再刷新一次，取得停牌前的最终行情
+    if (active || m_wasActive) {
+        requestRefresh();
+    }
+    m_wasActive = active;
+    
+    scheduleAutoRefresh(now);
+}
+
+int DataManager::pendingDeliveries() const
+{
+    int count = 0;
+    for (const Subscription& subscription : m_subscriptions) {
+        count += subscription.pending.size();
+    }
+    return count;
+}
+
+void DataManager::deliverPendingUpdates()
+{
+    TRACE_SCOPE("DataManager::deliverPendingUpdates");
+    m_deliveryScheduled = false;
+    
+    // 回调中可能取消订阅，先复制订阅编号
+    const QList<int> ids = m_subscriptions.keys();
+    for (int id : ids) {
+        auto it = m_subscriptions.find(id);
+        if (it == m_subscriptions.end() || it->pending.isEmpty()) {
+            continue;
+        }
+        
+        QVector<StockUpdate> updates;
+        updates.reserve(it->pending.size());
+        for (auto p = it->pending.cbegin(); p != it->pending.cend(); ++p) {
+            StockUpdate update;
+            update.code = p.key();
+            update.fields = p.value();
+            updates.append(update);
+        }
+        it->pending.clear();
+        
+        if (it->context && it->callback) {
+            SubscriptionCallback callback = it->callback;
+            if (it->context->thread() == QThread::currentThread()) {
+                callback(updates);
+            } else {
+                // 上下文在其他线程时排队到其线程执行，上下文先销毁则不再回调
+                QMetaObject::invokeMethod(it->context, [callback, updates]() {
+                    callback(updates);
+                }, Qt::QueuedConnection);
+            }
+        }
+    }
+}
+
+DataManager::StockFields DataManager::diffStock(const StockItem *oldStock, const StockItem *newStock)
+{
+    if (!oldStock || !newStock) {
+        return (oldStock == newStock) ? NoField : AllFields;
+    }
+    
+    StockFields changed = NoField;
+    
+    if (oldStock->getCurrentPrice() != newStock->getCurrentPrice()
+        || oldStock->getOpenPrice() != newStock->getOpenPrice()
+        || oldStock->getHighPrice() != newStock->getHighPrice()
+        || oldStock->getLowPrice() != newStock->getLowPrice()
+        || oldStock->getPreviousClose() != newStock->getPreviousClose()) {
+        changed |= PriceField;
+    }
+    
+    if (oldStock->getVolume() != newStock->getVolume()
+        || oldStock->getAmount() != newStock->getAmount()) {
+        changed |= VolumeField;
+    }
+    
+    // 历史数据只比较长度和最后一个元素，未复制的数据直接视为未变化
+    const QVector<StockTradeData>& oldKLine = oldStock->getKLineData();
+    const QVector<StockTradeData>& newKLine = newStock->getKLineData();
+    if (!oldKLine.isSharedWith(newKLine)) {
+        if (oldKLine.size() != newKLine.size()
+            || (!newKLine.isEmpty()
+                && (oldKLine.last().close != newKLine.last().close
+                    || oldKLine.last().volume != newKLine.last().volume
+                    || oldKLine.last().timestamp != newKLine.last().timestamp))) {
+            changed |= KLineField;
+        }
+    }
+    
+    // 分时数据只有最后一个点（当前分钟）会变化，比较点数和最后一个点即可
+    int seriesCount = newStock->getTimeSeriesCount();
+    if (oldStock->getTimeSeriesCount() != seriesCount) {
+        changed |= TimeSeriesField;
+    } else if (seriesCount > 0) {
+        const TimeSeriesPoint& oldLast = oldStock->getLastTimeSeriesPoint();
+        const TimeSeriesPoint& newLast = newStock->getLastTimeSeriesPoint();
+        if (oldLast.price != newLast.price || oldLast.volume != newLast.volume
+            || oldLast.timestamp != newLast.timestamp) {
+            changed |= TimeSeriesField;
+        }
+    }
+    
+    return changed;
 } 
\ No newline at end of file
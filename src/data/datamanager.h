@@ -1,9 +1,19 @@
 #pragma once
 
 #include "marketdata.h"
+#include "klinehistory.h"
+#include "intradayhistory.h"
+#include "memoryaccounting.h"
+#include "tradingcalendar.h"
+#include "quoteindex.h"
 #include <QObject>
 #include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QPointer>
+#include <functional>
 #include <memory>
+#include <atomic>
 
 /**
  * @brief 数据管理器类
@@ -14,6 +24,36 @@ class DataManager : public QObject
 {
     Q_OBJECT
 
+public:
+    /**
+     * @brief 股票字段分组，用于订阅指定字段的变化
+     */
+    enum StockField {
+        NoField = 0x0,
+        PriceField = 0x1,        // 现价、开盘、最高、最低、昨收
+        VolumeField = 0x2,       // 成交量、成交金额
+        KLineField = 0x4,        // K线数据
+        TimeSeriesField = 0x8,   // 分时数据
+        AllFields = 0xF
+    };
+    Q_DECLARE_FLAGS(StockFields, StockField)
+
+    /**
+     * @brief 单只股票的变化通知
+     */
+    struct StockUpdate {
+        QString code;            // 股票代码
+        StockFields fields;      // 发生变化的字段
+    };
+
+    /**
+     * @brief 订阅回调，参数为一次事件循环内合并的变化列表
+     */
+    using SubscriptionCallback = std::function<void(const QVector<StockUpdate>&)>;
+
+    static const int kMaxRefreshBackoff = 4;           // 无变化时刷新间隔最多放大的倍数
+    static const int kMaxIdleInterval = 60 * 60 * 1000;  // 休市时最长等待一小时后重新核对时间
+
 public:
     explicit DataManager(QObject *parent = nullptr);
     ~DataManager();
@@ -38,14 +78,26 @@ public:
      */
     QStringList getStocksByMarketType(StockItem::MarketType type) const;
 
+    /**
+     * @brief 获取行情批量查询索引
+     * @return 与当前市场数据同步的索引，按编号批量读取字段、按板块或排名取区间，
+     *         适合每帧需要读取大量股票的面板和统计
+     */
+    const QuoteIndex* quoteIndex() const { return &m_quoteIndex; }
+
     /**
      * @brief 设置自动刷新间隔
+     *
+     * 这是交易时段内的基础间隔；订阅的股票连续没有变化时间隔逐步加倍，最多kMaxRefreshBackoff倍
      * @param msecs 刷新间隔（毫秒）
      */
     void setRefreshInterval(int msecs);
 
     /**
      * @brief 启动自动刷新
+     *
+     * 按交易日历安排：集合竞价和连续竞价期间定时刷新，进入午休或收盘时再刷新一次，
+     * 之后定时器直接等到下一个交易阶段开始，休市期间不再发出刷新请求
      */
     void startAutoRefresh();
 
@@ -54,6 +106,69 @@ public:
      */
     void stopAutoRefresh();
 
+    /**
+     * @brief 订阅指定股票的字段变化
+     *
+     * 只比较已订阅的股票，变化在当前事件循环结束后合并为一批回调
+     * @param codes 股票代码列表
+     * @param fields 关心的字段
+     * @param context 上下文对象，销毁时自动取消订阅；回调在其线程中执行，
+     *        与数据管理器不在同一线程时排队投递
+     * @param callback 回调函数
+     * @return 订阅编号
+     */
+    int subscribe(const QStringList& codes, StockFields fields,
+                  QObject *context, SubscriptionCallback callback);
+
+    /**
+     * @brief 修改订阅的股票
+     * @param id 订阅编号
+     * @param codes 新的股票代码列表
+     */
+    void setSubscriptionCodes(int id, const QStringList& codes);
+
+    /**
+     * @brief 取消订阅
+     * @param id 订阅编号
+     */
+    void unsubscribe(int id);
+
+    /**
+     * @brief 获取K线历史数据缓存
+     * @return 历史数据缓存，图表平移时从中按块加载更早的K线
+     */
+    KLineHistory* kLineHistory() { return &m_kLineHistory; }
+
+    /**
+     * @brief 获取历史分时数据缓存
+     * @return 历史分时缓存，多日分时图从中按日加载往日的分钟数据
+     */
+    IntradayHistory* intradayHistory() { return &m_intradayHistory; }
+
+    /**
+     * @brief 获取交易日历
+     * @return 交易日历，自动刷新按其交易阶段安排
+     */
+    TradingCalendar* tradingCalendar() { return &m_tradingCalendar; }
+
+    /**
+     * @brief 累计收到的行情推送次数，可在任意线程读取
+     */
+    quint64 updateCount() const { return m_updateCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 等待投递给订阅者的股票变化数量
+     */
+    int pendingDeliveries() const;
+
+    /**
+     * @brief 重新估算并登记市场数据占用的内存
+     *
+     * 估算要遍历所有股票，行情推送时只在股票数量变化时进行；
+     * 统计采样前调用一次以取得最新值
+     */
+    void updateMemoryCharge();
+
 public slots:
     /**
      * @brief 更新市场数据
@@ -84,8 +199,58 @@ private slots:
      */
     void onAutoRefreshTimer();
 
+    /**
+     * @brief 向订阅者投递本轮事件循环积累的变化
+     */
+    void deliverPendingUpdates();
+
+private:
+    /**
+     * @brief 比较同一股票新旧数据的变化字段
+     * @param oldStock 旧数据，可以为nullptr
+     * @param newStock 新数据，可以为nullptr
+     * @return 变化的字段
+     */
+    static StockFields diffStock(const StockItem *oldStock, const StockItem *newStock);
+
+    /**
+     * @brief 按当前交易阶段安排下一次自动刷新
+     * @param now 当前时间
+     */
+    void scheduleAutoRefresh(const QDateTime& now);
+
+    /**
+     * @brief 订阅信息
+     */
+    struct Subscription {
+        QSet<QString> codes;                  // 订阅的股票
+        StockFields fields;                   // 关心的字段
+        QPointer<QObject> context;            // 上下文对象
+        SubscriptionCallback callback;        // 回调函数
+        QHash<QString, StockFields> pending;  // 待投递的变化
+    };
+
 private:
     MarketData m_marketData;        // 市场数据
-    QTimer m_autoRefreshTimer;      // 自动刷新定时器
+    MemoryCharge m_marketDataCharge;  // 市场数据的内存登记
+    QuoteIndex m_quoteIndex;        // 行情批量查询索引
+    QTimer m_autoRefreshTimer;      // 自动刷新定时器（单次触发，每次重新安排）
     int m_refreshInterval;          // 刷新间隔（毫秒）
-}; 
\ No newline at end of file
+    int m_currentInterval;          // 按行情活跃程度调整后的刷新间隔（毫秒）
+    bool m_autoRefreshEnabled;      // 是否启用自动刷新
+    bool m_wasActive;               // 上次触发时是否处于交易阶段
+    bool m_activitySeen;            // 上次刷新后订阅的股票是否有变化
+    TradingCalendar m_tradingCalendar;  // 交易日历
+    
+    // 订阅
+    QHash<int, Subscription> m_subscriptions;          // 订阅编号 -> 订阅信息
+    QHash<QString, QVector<int>> m_subscribersByCode;  // 股票代码 -> 订阅编号
+    int m_nextSubscriptionId;                          // 下一个订阅编号
+    bool m_deliveryScheduled;                          // 是否已安排投递
+    std::atomic<quint64> m_updateCount;                // 收到的行情推送次数
+    
+    KLineHistory m_kLineHistory;    // K线历史数据缓存
+    IntradayHistory m_intradayHistory;  // 历史分时数据缓存
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(DataManager::StockFields) 
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "intradayhistory.h"
+
+IntradayHistory::IntradayHistory(QObject *parent)
+    : QObject(parent)
+    , m_calendar(&TradingCalendar::weekdays())
+    , m_days(200 * 240)  // 默认缓存200个股票日
+    , m_charge(MemoryAccounting::HistoryTag)
+{
+}
+
+IntradayHistory::~IntradayHistory()
+{
+}
+
+void IntradayHistory::setLoader(Loader loader)
+{
+    m_loader = std::move(loader);
+    m_days.clear();
+    m_pending.clear();
+    updateCharge();
+}
+
+void IntradayHistory::setTradingCalendar(const TradingCalendar *calendar)
+{
+    m_calendar = calendar ? calendar : &TradingCalendar::weekdays();
+}
+
+void IntradayHistory::setCacheCapacity(int points)
+{
+    m_days.setMaxCost(points);
+    updateCharge();
+}
+
+bool IntradayHistory::day(const QString& code, const QDate& date, QVector<TimeSeriesPoint> *points)
+{
+    QString key = dayKey(code, date);
+    if (QVector<TimeSeriesPoint> *cached = m_days.object(key)) {
+        *points = *cached;
+        return true;
+    }
+
+    // 非交易日和没有数据来源时视为没有往日数据
+    if (!m_loader || !m_calendar->isTradingDay(date)) {
+        points->clear();
+        return true;
+    }
+
+    if (!m_pending.contains(key)) {
+        m_pending.insert(key);
+        m_loader(code, date);
+    }
+    return false;
+}
+
+void IntradayHistory::insertDay(const QString& code, const QDate& date, const QVector<TimeSeriesPoint>& points, bool ok)
+{
+    QString key = dayKey(code, date);
+    m_pending.remove(key);
+
+    // 空数据也缓存，避免反复请求非交易日
+    if (ok) {
+        m_days.insert(key, new QVector<TimeSeriesPoint>(points), qMax(1, int(points.size())));
+        updateCharge();
+    }
+
+    emit dayLoaded(code, date, ok);
+}
+
+void IntradayHistory::clear()
+{
+    m_days.clear();
+    m_pending.clear();
+    updateCharge();
+}
+
+qint64 IntradayHistory::byteSize() const
+{
+    return qint64(m_days.totalCost()) * sizeof(TimeSeriesPoint);
+}
+
+QString IntradayHistory::dayKey(const QString& code, const QDate& date)
+{
+    return QString("%1|%2").arg(code).arg(date.toJulianDay());
+}
+
+void IntradayHistory::updateCharge()
+{
+    m_charge.set(byteSize());
+}
\ No newline at end of file
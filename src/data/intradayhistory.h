@@ -0,0 +1,120 @@
+#pragma once
+
+#include "stockitem.h"
+#include "memoryaccounting.h"
+#include "tradingcalendar.h"
+#include <QObject>
+#include <QCache>
+#include <QSet>
+#include <QDate>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/**
+ * @brief 历史分时数据缓存
+ *
+ * 多日分时图按交易日请求往日的分钟数据，以“股票代码+日期”为键放入LRU缓存，
+ * 缓存总量按分时点数限制；往日数据不再变化，切换股票或天数时直接命中缓存。
+ * 未缓存的日期异步加载，加载完成后发出dayLoaded信号；非交易日按交易日历直接视为没有数据
+ */
+class IntradayHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 历史分时加载函数
+     *
+     * 参数依次为股票代码、交易日。只发起请求，不等待结果；
+     * 结果（该日的分时数据，含均价，按时间升序）通过insertDay送回
+     */
+    using Loader = std::function<void(const QString&, const QDate&)>;
+
+    explicit IntradayHistory(QObject *parent = nullptr);
+    ~IntradayHistory();
+
+    /**
+     * @brief 设置加载函数
+     * @param loader 加载函数
+     */
+    void setLoader(Loader loader);
+
+    /**
+     * @brief 是否已设置加载函数
+     */
+    bool hasLoader() const { return static_cast<bool>(m_loader); }
+
+    /**
+     * @brief 设置交易日历
+     * @param calendar 交易日历，为空时只跳过周末
+     */
+    void setTradingCalendar(const TradingCalendar *calendar);
+
+    /**
+     * @brief 交易日历
+     */
+    const TradingCalendar* tradingCalendar() const { return m_calendar; }
+
+    /**
+     * @brief 设置缓存容量
+     * @param points 最多缓存的分时点数
+     */
+    void setCacheCapacity(int points);
+
+    /**
+     * @brief 获取一个交易日的分时数据
+     *
+     * 未缓存时发起加载（同一日只请求一次），完成后发出dayLoaded信号
+     * @param code 股票代码
+     * @param date 交易日
+     * @param points 输出的分时数据，没有数据时为空
+     * @return 已缓存时返回true；正在加载时返回false
+     */
+    bool day(const QString& code, const QDate& date, QVector<TimeSeriesPoint> *points);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 估算缓存的分时数据占用的内存字节数
+     */
+    qint64 byteSize() const;
+
+public slots:
+    /**
+     * @brief 送回一个交易日加载完成的分时数据
+     * @param code 股票代码
+     * @param date 交易日
+     * @param points 分时数据
+     * @param ok 是否加载成功，失败时不缓存，下次请求时重试
+     */
+    void insertDay(const QString& code, const QDate& date, const QVector<TimeSeriesPoint>& points, bool ok);
+
+signals:
+    /**
+     * @brief 一个交易日的分时数据加载完成
+     * @param ok 是否加载成功，成功时已放入缓存
+     */
+    void dayLoaded(const QString& code, const QDate& date, bool ok);
+
+private:
+    /**
+     * @brief 缓存键
+     */
+    static QString dayKey(const QString& code, const QDate& date);
+
+    /**
+     * @brief 缓存内容变化后更新内存登记
+     */
+    void updateCharge();
+
+private:
+    Loader m_loader;                                    // 加载函数
+    const TradingCalendar *m_calendar;                  // 交易日历
+    QCache<QString, QVector<TimeSeriesPoint>> m_days;   // 按日缓存，开销按分时点数计
+    QSet<QString> m_pending;                            // 正在加载的日期
+    MemoryCharge m_charge;                              // 缓存的内存登记
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "klinehistory.h"
+
+KLineHistory::KLineHistory(QObject *parent)
+    : QObject(parent)
+    , m_chunks(40 * kChunkSize)  // 默认缓存40块
+    , m_charge(MemoryAccounting::HistoryTag)
+{
+}
+
+KLineHistory::~KLineHistory()
+{
+}
+
+void KLineHistory::setLoader(Loader loader)
+{
+    m_loader = std::move(loader);
+    m_chunks.clear();
+    m_pending.clear();
+    updateCharge();
+}
+
+void KLineHistory::setCacheCapacity(int bars)
+{
+    m_chunks.setMaxCost(bars);
+    updateCharge();
+}
+
+bool KLineHistory::chunkBefore(const QString& code, qint64 barInterval, qint64 endTime, OhlcvSeries *chunk)
+{
+    QString key = chunkKey(code, barInterval, endTime);
+    if (OhlcvSeries *cached = m_chunks.object(key)) {
+        *chunk = *cached;
+        return true;
+    }
+
+    // 没有数据来源时视为没有更早的历史
+    if (!m_loader) {
+        *chunk = OhlcvSeries();
+        return true;
+    }
+
+    if (!m_pending.contains(key)) {
+        m_pending.insert(key);
+        m_loader(code, barInterval, endTime, kChunkSize);
+    }
+    return false;
+}
+
+void KLineHistory::insertChunk(const QString& code, qint64 barInterval, qint64 endTime, const OhlcvSeries& chunk, bool ok)
+{
+    QString key = chunkKey(code, barInterval, endTime);
+    m_pending.remove(key);
+
+    // 空块也缓存，避免反复请求不存在的历史
+    if (ok) {
+        m_chunks.insert(key, new OhlcvSeries(chunk), qMax(1, chunk.size()));
+        updateCharge();
+    }
+
+    emit chunkLoaded(code, barInterval, endTime, ok);
+}
+
+void KLineHistory::clear()
+{
+    m_chunks.clear();
+    m_pending.clear();
+    updateCharge();
+}
+
+qint64 KLineHistory::byteSize() const
+{
+    // 缓存开销按K线根数计，每根与OhlcvSeries::byteSize的估算相同
+    return qint64(m_chunks.totalCost()) * (8 * sizeof(double) + 2 * 2 * sizeof(int));
+}
+
+QString KLineHistory::chunkKey(const QString& code, qint64 barInterval, qint64 endTime)
+{
+    return QString("%1|%2|%3").arg(code).arg(barInterval).arg(endTime);
+}
+
+void KLineHistory::updateCharge()
+{
+    m_charge.set(byteSize());
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ohlcvseries.h"
+#include "memoryaccounting.h"
+#include <QObject>
+#include <QCache>
+#include <QSet>
+#include <QString>
+#include <functional>
+
+/**
+ * @brief K线历史数据分块缓存
+ *
+ * 图表平移到已加载数据的左边缘时按块向前请求历史K线，每块固定kChunkSize根，
+ * 以“股票代码+K线周期+块结束时间”为键放入LRU缓存，缓存总量按K线根数限制，
+ * 来回滚动时命中缓存，内存占用不随浏览过的历史长度增长。
+ * 未缓存的块异步加载，加载完成后发出chunkLoaded信号
+ */
+class KLineHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 历史数据加载函数
+     *
+     * 参数依次为股票代码、K线周期（毫秒）、结束时间（毫秒，不含）、K线数量。
+     * 只发起请求，不等待结果；结果（结束时间之前最多count根K线，按时间升序）通过insertChunk送回
+     */
+    using Loader = std::function<void(const QString&, qint64, qint64, int)>;
+
+    static const int kChunkSize = 500;  // 每块K线数量
+
+    explicit KLineHistory(QObject *parent = nullptr);
+    ~KLineHistory();
+
+    /**
+     * @brief 设置加载函数
+     * @param loader 加载函数
+     */
+    void setLoader(Loader loader);
+
+    /**
+     * @brief 是否已设置加载函数
+     */
+    bool hasLoader() const { return static_cast<bool>(m_loader); }
+
+    /**
+     * @brief 设置缓存容量
+     * @param bars 最多缓存的K线根数
+     */
+    void setCacheCapacity(int bars);
+
+    /**
+     * @brief 获取指定时间之前的一块历史K线
+     *
+     * 未缓存时发起加载（同一块只请求一次），完成后发出chunkLoaded信号
+     * @param code 股票代码
+     * @param barInterval K线周期（毫秒）
+     * @param endTime 结束时间（毫秒，不含）
+     * @param chunk 输出的历史K线，没有更早的数据时为空
+     * @return 已缓存时返回true；正在加载时返回false
+     */
+    bool chunkBefore(const QString& code, qint64 barInterval, qint64 endTime, OhlcvSeries *chunk);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 估算缓存的历史K线占用的内存字节数
+     */
+    qint64 byteSize() const;
+
+public slots:
+    /**
+     * @brief 送回一块加载完成的历史K线
+     * @param code 股票代码
+     * @param barInterval K线周期（毫秒）
+     * @param endTime 结束时间（毫秒，不含）
+     * @param chunk 历史K线
+     * @param ok 是否加载成功，失败时不缓存，下次请求时重试
+     */
+    void insertChunk(const QString& code, qint64 barInterval, qint64 endTime, const OhlcvSeries& chunk, bool ok);
+
+signals:
+    /**
+     * @brief 一块历史K线加载完成
+     * @param ok 是否加载成功，成功时已放入缓存
+     */
+    void chunkLoaded(const QString& code, qint64 barInterval, qint64 endTime, bool ok);
+
+private:
+    /**
+     * @brief 缓存键
+     */
+    static QString chunkKey(const QString& code, qint64 barInterval, qint64 endTime);
+
+    /**
+     * @brief 缓存内容变化后更新内存登记
+     */
+    void updateCharge();
+
+private:
+    Loader m_loader;                        // 加载函数
+    QCache<QString, OhlcvSeries> m_chunks;  // 历史块缓存，开销按K线根数计
+    QSet<QString> m_pending;                // 正在加载的块
+    MemoryCharge m_charge;                  // 缓存的内存登记
+};
\ No newline at end of file
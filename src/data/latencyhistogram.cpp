@@ -0,0 +1,89 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+void LatencyHistogram::record(qint64 micros)
+{
+    quint64 value = quint64(qMax<qint64>(0, micros));
+
+    m_counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(qint64(value), std::memory_order_relaxed);
+
+    // 其他线程可能同时更新最大值
+    qint64 current = m_max.load(std::memory_order_relaxed);
+    while (qint64(value) > current
+           && !m_max.compare_exchange_weak(current, qint64(value), std::memory_order_relaxed)) {
+    }
+}
+
+qint64 LatencyHistogram::percentile(double percent) const
+{
+    quint64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    // 至少要覆盖的样本数
+    quint64 target = quint64(std::ceil(qBound(0.0, percent, 100.0) / 100.0 * double(total)));
+    target = qMax<quint64>(1, target);
+
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_counts[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            // 桶上限可能超过实际出现的最大值
+            return qMin(bucketUpperBound(i), max());
+        }
+    }
+
+    // 读取期间有新样本记录
+    return max();
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<quint64>& bucket : m_counts) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_total.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketIndex(quint64 micros)
+{
+    const quint64 limit = (quint64(1) << (kMaxShift + kSubBucketBits)) - 1;
+    micros = qMin(micros, limit);
+
+    if (micros < quint64(kSubBucketCount)) {
+        return int(micros);
+    }
+
+    // 最高位决定数量级，其后的kSubBucketBits-1位决定子桶
+    int highestBit = 63 - qCountLeadingZeroBits(micros);
+    int shift = highestBit - (kSubBucketBits - 1);
+    int subBucket = int(micros >> shift);
+    return kSubBucketCount + (shift - 1) * kSubBucketHalf + (subBucket - kSubBucketHalf);
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < kSubBucketCount) {
+        return index;
+    }
+
+    int offset = index - kSubBucketCount;
+    int shift = offset / kSubBucketHalf + 1;
+    qint64 subBucket = offset % kSubBucketHalf + kSubBucketHalf;
+    return ((subBucket + 1) << shift) - 1;
+}
\ No newline at end of file
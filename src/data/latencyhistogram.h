@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief 延迟直方图（HDR）
+ *
+ * 以微秒为单位记录延迟，桶宽随数值按2的幂增长：小于128微秒的值逐一计数，
+ * 更大的值每个二进制数量级分为64个子桶，相对误差不超过1/64（约1.6%），
+ * 最大可记录约71分钟。桶计数是原子变量，记录只做一次无锁加法，
+ * 可以在任意线程记录，同时在另一线程查询分位数
+ */
+class LatencyHistogram
+{
+public:
+    static const int kSubBucketBits = 7;                             // 子桶位数
+    static const int kSubBucketCount = 1 << kSubBucketBits;          // 逐一计数的区间大小
+    static const int kSubBucketHalf = kSubBucketCount / 2;           // 每个数量级的子桶数
+    static const int kMaxShift = 25;                                 // 最大数量级（2^32微秒）
+    static const int kBucketCount = kSubBucketCount + kMaxShift * kSubBucketHalf;
+
+    LatencyHistogram();
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief 记录一次延迟
+     * @param micros 延迟（微秒），负值按0记录，超出范围的按最大值记录
+     */
+    void record(qint64 micros);
+
+    /**
+     * @brief 记录的样本数
+     */
+    quint64 count() const { return m_total.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 最大延迟（微秒）
+     */
+    qint64 max() const { return m_max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 所有样本之和（微秒），两次读取之差除以样本数之差即为期间的平均延迟
+     */
+    qint64 sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 分位数
+     * @param percent 百分位（0~100），如50、99、99.9
+     * @return 不小于该比例样本的最小桶上限（微秒），没有样本时返回0
+     */
+    qint64 percentile(double percent) const;
+
+    /**
+     * @brief 清空记录
+     */
+    void reset();
+
+private:
+    /**
+     * @brief 数值所在的桶
+     */
+    static int bucketIndex(quint64 micros);
+
+    /**
+     * @brief 桶能表示的最大数值
+     */
+    static qint64 bucketUpperBound(int index);
+
+private:
+    std::atomic<quint64> m_counts[kBucketCount];  // 各桶计数
+    std::atomic<quint64> m_total;                 // 样本总数
+    std::atomic<qint64> m_sum;                    // 样本之和
+    std::atomic<qint64> m_max;                    // 最大值
+};
\ No newline at end of file
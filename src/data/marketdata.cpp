@@ -1,4 +1,11 @@
 #include "marketdata.h"
+#include <chrono>
+
+qint64 TickStamps::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
 
 MarketData::MarketData()
 {
@@ -17,6 +24,16 @@ const StockItem* MarketData::getStock(const QString& code) const
     return nullptr;
 }
 
+StockItem* MarketData::findStock(const QString& code)
+{
+    auto it = m_stocks.find(code);
+    if (it != m_stocks.end()) {
+        return &it.value();
+    }
+    
+    return nullptr;
+}
+
 void MarketData::addOrUpdateStock(const StockItem& stock)
 {
     m_stocks[stock.getCode()] = stock;
@@ -63,4 +80,17 @@ QDateTime MarketData::getUpdateTime() const
 void MarketData::setUpdateTime(const QDateTime& time)
 {
     m_updateTime = time;
-} 
\ No newline at end of file
+} 
+
+qint64 MarketData::byteSize() const
+{
+    qint64 bytes = sizeof(MarketData);
+    for (auto it = m_stocks.cbegin(); it != m_stocks.cend(); ++it) {
+        const StockItem& stock = it.value();
+        bytes += sizeof(StockItem)
+                 + (it.key().size() + stock.getCode().size()) * qint64(sizeof(QChar))
+                 + stock.getKLineData().capacity() * qint64(sizeof(StockTradeData))
+                 + stock.getClosedTimeSeriesData().capacity() * qint64(sizeof(TimeSeriesPoint));
+    }
+    return bytes;
+}
\ No newline at end of file
@@ -5,6 +5,22 @@
 #include <QDateTime>
 #include <QStringList>
 
+/**
+ * @brief 一次行情推送经过各处理阶段的时间戳
+ *
+ * 取自单调时钟（纳秒），0表示尚未经过该阶段；界面根据这些时间戳统计各阶段的延迟
+ */
+struct TickStamps {
+    qint64 received = 0;  // 收到原始数据
+    qint64 decoded = 0;   // 解析完成
+    qint64 applied = 0;   // 写入数据管理器
+    
+    /**
+     * @brief 当前单调时钟时间（纳秒）
+     */
+    static qint64 now();
+};
+
 /**
  * @brief 市场数据类
  * 
@@ -23,6 +39,15 @@ public:
      */
     const StockItem* getStock(const QString& code) const;
     
+    /**
+     * @brief 获取指定代码的股票（可修改）
+     * 
+     * 用于在上一次的数据上原地更新，数据与其他副本共享时先复制一次
+     * @param code 股票代码
+     * @return 股票对象指针，如果不存在则返回nullptr
+     */
+    StockItem* findStock(const QString& code);
+    
     /**
      * @brief 添加或更新股票
      * @param stock 股票对象
@@ -54,6 +79,18 @@ public:
      */
     QStringList getStocksByMarketType(StockItem::MarketType type) const;
     
+    /**
+     * @brief 原地更新所有股票
+     * @param function 对每只股票调用，参数为StockItem&
+     */
+    template <typename Function>
+    void updateAllStocks(Function function)
+    {
+        for (auto it = m_stocks.begin(); it != m_stocks.end(); ++it) {
+            function(it.value());
+        }
+    }
+    
     /**
      * @brief 清空所有数据
      */
@@ -71,7 +108,25 @@ public:
      */
     void setUpdateTime(const QDateTime& time);
     
+    /**
+     * @brief 获取处理链路时间戳
+     * @return 本次行情各阶段的时间戳
+     */
+    const TickStamps& getTickStamps() const { return m_tickStamps; }
+    
+    /**
+     * @brief 设置处理链路时间戳
+     * @param stamps 时间戳
+     */
+    void setTickStamps(const TickStamps& stamps) { m_tickStamps = stamps; }
+    
+    /**
+     * @brief 估算股票数据占用的内存字节数（含K线和分时数据）
+     */
+    qint64 byteSize() const;
+    
 private:
     QMap<QString, StockItem> m_stocks;  // 股票映射表 (代码 -> 股票对象)
     QDateTime m_updateTime;             // 最后更新时间
+    TickStamps m_tickStamps;            // 处理链路时间戳
 }; 
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "memoryaccounting.h"
+#include <QFile>
+#include <atomic>
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace {
+
+/**
+ * @brief 一个标签的计数器
+ */
+struct TagCounters {
+    std::atomic<qint64> bytes{0};
+    std::atomic<qint64> peakBytes{0};
+    std::atomic<qint64> blocks{0};
+    std::atomic<quint64> allocations{0};
+};
+
+TagCounters g_counters[MemoryAccounting::TagCount];
+
+} // namespace
+
+void MemoryAccounting::charge(Tag tag, qint64 oldBytes, qint64 newBytes)
+{
+    if (oldBytes == newBytes) {
+        return;
+    }
+
+    TagCounters& counters = g_counters[tag];
+    if (oldBytes == 0) {
+        counters.blocks.fetch_add(1, std::memory_order_relaxed);
+    } else if (newBytes == 0) {
+        counters.blocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (newBytes > 0) {
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    qint64 bytes = counters.bytes.fetch_add(newBytes - oldBytes, std::memory_order_relaxed) + newBytes - oldBytes;
+
+    qint64 peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak
+           && !counters.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryAccounting::Usage MemoryAccounting::usage(Tag tag)
+{
+    const TagCounters& counters = g_counters[tag];
+
+    Usage usage;
+    usage.bytes = counters.bytes.load(std::memory_order_relaxed);
+    usage.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    usage.blocks = counters.blocks.load(std::memory_order_relaxed);
+    usage.allocations = counters.allocations.load(std::memory_order_relaxed);
+    return usage;
+}
+
+QString MemoryAccounting::tagName(Tag tag)
+{
+    switch (tag) {
+    case DataStoreTag:
+        return "行情数据";
+    case HistoryTag:
+        return "历史缓存";
+    case TableModelTag:
+        return "表格模型";
+    case ChartLayerTag:
+        return "图表图层";
+    case TagCount:
+        break;
+    }
+    return QString();
+}
+
+void MemoryAccounting::resetPeaks()
+{
+    for (TagCounters& counters : g_counters) {
+        counters.peakBytes.store(counters.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+qint64 MemoryAccounting::residentMemory()
+{
+#if defined(Q_OS_LINUX)
+    // /proc/self/statm的第二列是常驻内存页数
+    QFile file("/proc/self/statm");
+    if (file.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> fields = file.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return 0;
+}
+
+MemoryCharge::MemoryCharge(MemoryAccounting::Tag tag)
+    : m_tag(tag)
+    , m_bytes(0)
+{
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    MemoryAccounting::charge(m_tag, m_bytes, 0);
+}
+
+void MemoryCharge::set(qint64 bytes)
+{
+    MemoryAccounting::charge(m_tag, m_bytes, bytes);
+    m_bytes = bytes;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief 分子系统的内存统计
+ *
+ * 各子系统用MemoryCharge登记自己持有的数据块（行情快照、历史缓存、表格行、图表缓存和图层），
+ * 数据块大小变化时更新登记值。每个标签累计当前字节数、峰值、块数和分配次数，
+ * 计数是原子变量，可在任意线程更新和读取。字节数是按容器容量估算的，不含分配器开销
+ */
+class MemoryAccounting
+{
+public:
+    /**
+     * @brief 统计标签
+     */
+    enum Tag {
+        DataStoreTag,     // 数据管理器中的行情数据
+        HistoryTag,       // K线和分时历史缓存
+        TableModelTag,    // 行情表格模型
+        ChartLayerTag,    // 图表数据缓存和静态层图像
+        TagCount
+    };
+
+    /**
+     * @brief 一个标签的统计
+     */
+    struct Usage {
+        qint64 bytes = 0;         // 当前字节数
+        qint64 peakBytes = 0;     // 峰值字节数
+        qint64 blocks = 0;        // 当前登记的数据块
+        quint64 allocations = 0;  // 累计分配次数（新建或改变大小）
+    };
+
+    /**
+     * @brief 登记一个数据块的大小变化
+     * @param tag 标签
+     * @param oldBytes 原大小，0表示新建
+     * @param newBytes 新大小，0表示释放
+     */
+    static void charge(Tag tag, qint64 oldBytes, qint64 newBytes);
+
+    /**
+     * @brief 获取标签的统计
+     */
+    static Usage usage(Tag tag);
+
+    /**
+     * @brief 标签名称
+     */
+    static QString tagName(Tag tag);
+
+    /**
+     * @brief 把各标签的峰值重置为当前值
+     */
+    static void resetPeaks();
+
+    /**
+     * @brief 进程常驻内存，与各标签的估算值对照
+     * @return 字节数，平台不支持时返回0
+     */
+    static qint64 residentMemory();
+};
+
+/**
+ * @brief 一个登记在某个标签下的数据块
+ *
+ * 作为成员放在数据的持有者中，数据大小变化时调用set，析构时自动注销
+ */
+class MemoryCharge
+{
+public:
+    explicit MemoryCharge(MemoryAccounting::Tag tag);
+    ~MemoryCharge();
+
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    /**
+     * @brief 更新数据块大小
+     * @param bytes 字节数
+     */
+    void set(qint64 bytes);
+
+    /**
+     * @brief 当前登记的字节数
+     */
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    MemoryAccounting::Tag m_tag;  // 标签
+    qint64 m_bytes;               // 登记的字节数
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "minmaxpyramid.h"
+
+MinMaxPyramid::MinMaxPyramid()
+    : m_count(0)
+{
+}
+
+MinMaxPyramid::~MinMaxPyramid()
+{
+}
+
+void MinMaxPyramid::update(const double *low, const double *high, int count, int from)
+{
+    m_count = count;
+
+    int childCount = count;
+    int dirty = qMax(0, from);  // 下一级中第一个需要重算的子块
+    int level = 0;
+
+    while (childCount > 1) {
+        int blockCount = (childCount + 1) / 2;
+        if (m_levels.size() <= level) {
+            m_levels.append(QVector<int>());
+        }
+
+        QVector<int>& blocks = m_levels[level];
+        blocks.resize(blockCount * 2);
+        const int *children = level > 0 ? m_levels[level - 1].constData() : nullptr;
+
+        for (int block = dirty / 2; block < blockCount; ++block) {
+            int left = block * 2;
+            int right = left + 1;
+
+            int minIndex = children ? children[left * 2] : left;
+            int maxIndex = children ? children[left * 2 + 1] : left;
+
+            // 最后一块可能只有一个子块
+            if (right < childCount) {
+                int rightMin = children ? children[right * 2] : right;
+                int rightMax = children ? children[right * 2 + 1] : right;
+                if (low[rightMin] < low[minIndex]) {
+                    minIndex = rightMin;
+                }
+                if (high[rightMax] > high[maxIndex]) {
+                    maxIndex = rightMax;
+                }
+            }
+
+            blocks[block * 2] = minIndex;
+            blocks[block * 2 + 1] = maxIndex;
+        }
+
+        dirty /= 2;
+        childCount = blockCount;
+        ++level;
+    }
+
+    m_levels.resize(level);
+}
+
+void MinMaxPyramid::clear()
+{
+    m_levels.clear();
+    m_count = 0;
+}
+
+void MinMaxPyramid::range(const double *low, const double *high, int begin, int end,
+                          int *minIndex, int *maxIndex) const
+{
+    int resultMin = begin;
+    int resultMax = begin;
+
+    int i = begin;
+    while (i < end) {
+        // 选取从i开始、完全落在区间内的最大块
+        int step = 1;
+        int level = -1;
+        while (level + 1 < m_levels.size()) {
+            int size = step * 2;
+            if (i % size != 0 || qMin(i + size, m_count) > end) {
+                break;
+            }
+            step = size;
+            ++level;
+        }
+
+        int blockMin = i;
+        int blockMax = i;
+        if (level >= 0) {
+            const QVector<int>& blocks = m_levels[level];
+            int block = i / step;
+            blockMin = blocks[block * 2];
+            blockMax = blocks[block * 2 + 1];
+        }
+
+        if (low[blockMin] < low[resultMin]) {
+            resultMin = blockMin;
+        }
+        if (high[blockMax] > high[resultMax]) {
+            resultMax = blockMax;
+        }
+
+        i = qMin(i + step, m_count);
+    }
+
+    *minIndex = resultMin;
+    *maxIndex = resultMax;
+}
+
+void MinMaxPyramid::decimate(const double *low, const double *high, int first, int last, int columns,
+                             QVector<int> *indices) const
+{
+    indices->clear();
+
+    int count = last - first;
+    if (count <= 0) {
+        return;
+    }
+
+    if (columns <= 0 || count <= columns * 2) {
+        indices->reserve(count);
+        for (int i = first; i < last; ++i) {
+            indices->append(i);
+        }
+        return;
+    }
+
+    indices->reserve(columns * 2);
+    for (int column = 0; column < columns; ++column) {
+        int begin = first + int(qint64(count) * column / columns);
+        int end = first + int(qint64(count) * (column + 1) / columns);
+        if (begin >= end) {
+            continue;
+        }
+
+        int minIndex = 0;
+        int maxIndex = 0;
+        range(low, high, begin, end, &minIndex, &maxIndex);
+
+        // 按时间先后输出，保证折线走向正确
+        indices->append(qMin(minIndex, maxIndex));
+        if (minIndex != maxIndex) {
+            indices->append(qMax(minIndex, maxIndex));
+        }
+    }
+}
\ No newline at end of file
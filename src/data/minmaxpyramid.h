@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QVector>
+
+/**
+ * @brief 区间极值金字塔
+ *
+ * 对一列取值区间[low, high]预先计算多级汇总：第k级每块覆盖2^(k+1)个元素，
+ * 记录块内最低值和最高值的下标。任意区间的极值查询只需组合O(log n)个块，
+ * 返回的是原始数据下标，因此降采样后的最高点和最低点与原始数据完全一致。
+ *
+ * 金字塔本身不保存数据，每次调用时传入数据指针；折线图传入同一列作为low和high
+ */
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid();
+    ~MinMaxPyramid();
+
+    /**
+     * @brief 重新计算从指定位置开始的汇总
+     * @param low 每个元素的最低值
+     * @param high 每个元素的最高值
+     * @param count 元素数量
+     * @param from 第一个发生变化的元素下标，追加或修改末尾元素时只需O(log n)
+     */
+    void update(const double *low, const double *high, int count, int from = 0);
+
+    /**
+     * @brief 清空汇总
+     */
+    void clear();
+
+    /**
+     * @brief 查询区间[begin, end)内最低值和最高值的下标
+     * @param low 每个元素的最低值
+     * @param high 每个元素的最高值
+     * @param begin 起始下标
+     * @param end 结束下标（不含），必须大于begin
+     * @param minIndex 输出最低值下标
+     * @param maxIndex 输出最高值下标
+     */
+    void range(const double *low, const double *high, int begin, int end,
+               int *minIndex, int *maxIndex) const;
+
+    /**
+     * @brief 按像素列降采样
+     *
+     * 每列只保留最低点和最高点（按下标先后排列），输出不超过2倍列数的下标；
+     * 数据量本来就不超过2倍列数时原样输出
+     * @param low 每个元素的最低值
+     * @param high 每个元素的最高值
+     * @param first 起始下标
+     * @param last 结束下标（不含）
+     * @param columns 像素列数
+     * @param indices 输出保留的下标
+     */
+    void decimate(const double *low, const double *high, int first, int last, int columns,
+                  QVector<int> *indices) const;
+
+    /**
+     * @brief 元素数量
+     */
+    int count() const { return m_count; }
+
+private:
+    // 每级按块交替存放最低值下标和最高值下标
+    QVector<QVector<int>> m_levels;
+    int m_count;
+};
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "ohlcvseries.h"
+#include <QtMath>
+
+OhlcvSeries::OhlcvSeries()
+{
+}
+
+OhlcvSeries::~OhlcvSeries()
+{
+}
+
+OhlcvSeries OhlcvSeries::fromKLineData(const QVector<StockTradeData>& kLineData)
+{
+    OhlcvSeries series;
+    series.reserve(kLineData.size());
+
+    for (const StockTradeData& data : kLineData) {
+        series.append(data);
+    }
+
+    return series;
+}
+
+void OhlcvSeries::append(qint64 time, double open, double high, double low, double close, double volume)
+{
+    m_time.append(time);
+    m_open.append(open);
+    m_high.append(high);
+    m_low.append(low);
+    m_close.append(close);
+    m_volume.append(volume);
+
+    updateSummaries(size() - 1);
+}
+
+void OhlcvSeries::append(const StockTradeData& data)
+{
+    append(data.timestamp.toMSecsSinceEpoch(), data.open, data.high, data.low, data.close, double(data.volume));
+}
+
+void OhlcvSeries::replaceLast(const StockTradeData& data)
+{
+    if (isEmpty()) {
+        return;
+    }
+
+    int last = size() - 1;
+    m_time[last] = data.timestamp.toMSecsSinceEpoch();
+    m_open[last] = data.open;
+    m_high[last] = data.high;
+    m_low[last] = data.low;
+    m_close[last] = data.close;
+    m_volume[last] = double(data.volume);
+
+    updateSummaries(last);
+}
+
+void OhlcvSeries::prepend(const OhlcvSeries& older)
+{
+    if (older.isEmpty()) {
+        return;
+    }
+
+    m_time = older.m_time + m_time;
+    m_open = older.m_open + m_open;
+    m_high = older.m_high + m_high;
+    m_low = older.m_low + m_low;
+    m_close = older.m_close + m_close;
+    m_volume = older.m_volume + m_volume;
+
+    updateSummaries(0);
+}
+
+void OhlcvSeries::removeFirst(int count)
+{
+    count = qMin(count, size());
+    if (count <= 0) {
+        return;
+    }
+
+    m_time.remove(0, count);
+    m_open.remove(0, count);
+    m_high.remove(0, count);
+    m_low.remove(0, count);
+    m_close.remove(0, count);
+    m_volume.remove(0, count);
+
+    updateSummaries(0);
+}
+
+OhlcvSeries OhlcvSeries::mid(int begin, int end) const
+{
+    begin = qBound(0, begin, size());
+    end = qBound(begin, end, size());
+
+    OhlcvSeries series;
+    int count = end - begin;
+    series.m_time = m_time.mid(begin, count);
+    series.m_open = m_open.mid(begin, count);
+    series.m_high = m_high.mid(begin, count);
+    series.m_low = m_low.mid(begin, count);
+    series.m_close = m_close.mid(begin, count);
+    series.m_volume = m_volume.mid(begin, count);
+    series.updateSummaries(0);
+    return series;
+}
+
+void OhlcvSeries::reserve(int size)
+{
+    m_time.reserve(size);
+    m_open.reserve(size);
+    m_high.reserve(size);
+    m_low.reserve(size);
+    m_close.reserve(size);
+    m_volume.reserve(size);
+    m_volumeSum.reserve(size);
+    m_closeSum.reserve(size);
+}
+
+void OhlcvSeries::clear()
+{
+    m_time.clear();
+    m_open.clear();
+    m_high.clear();
+    m_low.clear();
+    m_close.clear();
+    m_volume.clear();
+    m_volumeSum.clear();
+    m_closeSum.clear();
+    m_pricePyramid.clear();
+    m_volumePyramid.clear();
+}
+
+void OhlcvSeries::priceRange(int begin, int end, int *lowIndex, int *highIndex) const
+{
+    m_pricePyramid.range(m_low.constData(), m_high.constData(), begin, end, lowIndex, highIndex);
+}
+
+double OhlcvSeries::maxVolume(int begin, int end) const
+{
+    int minIndex = 0;
+    int maxIndex = 0;
+    m_volumePyramid.range(m_volume.constData(), m_volume.constData(), begin, end, &minIndex, &maxIndex);
+    return m_volume[maxIndex];
+}
+
+double OhlcvSeries::volumeSum(int begin, int end) const
+{
+    if (begin >= end) {
+        return 0.0;
+    }
+
+    return m_volumeSum[end - 1] - (begin > 0 ? m_volumeSum[begin - 1] : 0.0);
+}
+
+double OhlcvSeries::closeAverage(int end, int period) const
+{
+    if (period <= 0 || end < period || end > size()) {
+        return qQNaN();
+    }
+
+    double sum = m_closeSum[end - 1] - (end > period ? m_closeSum[end - period - 1] : 0.0);
+    return sum / period;
+}
+
+qint64 OhlcvSeries::byteSize() const
+{
+    // 8列数据加上两个金字塔（每级交替存放两个下标，各级合计约2n个int）
+    return qint64(size()) * (8 * sizeof(double) + 2 * 2 * sizeof(int)) + sizeof(OhlcvSeries);
+}
+
+void OhlcvSeries::updateSummaries(int from)
+{
+    // 累计和从第一个变化的位置开始重算
+    m_volumeSum.resize(size());
+    m_closeSum.resize(size());
+    for (int i = from; i < size(); ++i) {
+        m_volumeSum[i] = (i > 0 ? m_volumeSum[i - 1] : 0.0) + m_volume[i];
+        m_closeSum[i] = (i > 0 ? m_closeSum[i - 1] : 0.0) + m_close[i];
+    }
+
+    m_pricePyramid.update(m_low.constData(), m_high.constData(), size(), from);
+    m_volumePyramid.update(m_volume.constData(), m_volume.constData(), size(), from);
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "stockitem.h"
+#include "minmaxpyramid.h"
+#include <QVector>
+
+/**
+ * @brief K线列式数据类
+ *
+ * 按列连续存放时间、开高低收和成交量，供图表批量绘制使用；
+ * 追加时同步维护最高/最低价和成交量的极值金字塔及成交量、收盘价累计和，
+ * 任意区间的极值在O(log n)内得到，成交量合计和均线值在O(1)内得到
+ */
+class OhlcvSeries
+{
+public:
+    OhlcvSeries();
+    ~OhlcvSeries();
+
+    /**
+     * @brief 从K线数据构造
+     * @param kLineData K线数据
+     * @return 列式数据
+     */
+    static OhlcvSeries fromKLineData(const QVector<StockTradeData>& kLineData);
+
+    /**
+     * @brief 追加一根K线
+     */
+    void append(qint64 time, double open, double high, double low, double close, double volume);
+
+    /**
+     * @brief 追加一根K线
+     * @param data K线数据
+     */
+    void append(const StockTradeData& data);
+
+    /**
+     * @brief 替换最后一根K线
+     * @param data K线数据
+     */
+    void replaceLast(const StockTradeData& data);
+
+    /**
+     * @brief 在前面插入更早的K线
+     * @param older 更早的K线，时间需早于当前第一根
+     */
+    void prepend(const OhlcvSeries& older);
+
+    /**
+     * @brief 删除前面的K线
+     * @param count 删除数量
+     */
+    void removeFirst(int count);
+
+    /**
+     * @brief 取出区间[begin, end)内的K线，汇总数据在副本上重建
+     *
+     * 副本不与原数据共享，之后原数据原地修改时不会复制
+     * @return 独立的列式数据
+     */
+    OhlcvSeries mid(int begin, int end) const;
+
+    /**
+     * @brief 预留空间
+     * @param size K线数量
+     */
+    void reserve(int size);
+
+    /**
+     * @brief 清空数据
+     */
+    void clear();
+
+    /**
+     * @brief K线数量
+     */
+    int size() const { return m_time.size(); }
+
+    /**
+     * @brief 是否为空
+     */
+    bool isEmpty() const { return m_time.isEmpty(); }
+
+    // 列数据访问
+    const QVector<qint64>& time() const { return m_time; }
+    const QVector<double>& open() const { return m_open; }
+    const QVector<double>& high() const { return m_high; }
+    const QVector<double>& low() const { return m_low; }
+    const QVector<double>& close() const { return m_close; }
+    const QVector<double>& volume() const { return m_volume; }
+
+    /**
+     * @brief 查询区间[begin, end)内最低价和最高价所在的K线下标
+     */
+    void priceRange(int begin, int end, int *lowIndex, int *highIndex) const;
+
+    /**
+     * @brief 区间[begin, end)内单根K线的最大成交量
+     */
+    double maxVolume(int begin, int end) const;
+
+    /**
+     * @brief 区间[begin, end)内的成交量合计
+     */
+    double volumeSum(int begin, int end) const;
+
+    /**
+     * @brief 截至第end根（不含）的收盘价均线值
+     * @param end 结束下标（不含）
+     * @param period 均线周期
+     * @return 均线值，K线不足period根时返回NaN
+     */
+    double closeAverage(int end, int period) const;
+
+    /**
+     * @brief 估算占用的内存字节数（含汇总数据）
+     */
+    qint64 byteSize() const;
+
+private:
+    /**
+     * @brief 末尾K线变化后更新汇总数据
+     */
+    void updateSummaries(int from);
+
+private:
+    QVector<qint64> m_time;     // 时间戳（毫秒）
+    QVector<double> m_open;     // 开盘价
+    QVector<double> m_high;     // 最高价
+    QVector<double> m_low;      // 最低价
+    QVector<double> m_close;    // 收盘价
+    QVector<double> m_volume;   // 成交量
+
+    QVector<double> m_volumeSum;    // 成交量累计和，m_volumeSum[i]为前i+1根之和
+    QVector<double> m_closeSum;     // 收盘价累计和（均线用）
+    MinMaxPyramid m_pricePyramid;   // 最低价/最高价极值金字塔
+    MinMaxPyramid m_volumePyramid;  // 成交量极值金字塔
+};
\ No newline at end of file
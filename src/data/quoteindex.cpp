@@ -0,0 +1,153 @@
+#include "quoteindex.h"
+#include <QtNumeric>
+#include <algorithm>
+
+QuoteIndex::QuoteIndex()
+{
+}
+
+QuoteIndex::~QuoteIndex()
+{
+}
+
+void QuoteIndex::update(const MarketData& data)
+{
+    m_data = data;
+
+    // 排名缓存作废，保留容量供下次计算复用
+    for (QVector<int>& ranking : m_ranks) {
+        ranking.clear();
+    }
+    m_rows.fill(nullptr);
+
+    // 股票集合通常不变，先按上次的顺序比对代码，只有对不上时才查哈希表
+    const QMap<QString, StockItem>& stocks = m_data.getAllStocks();
+    int previousSize = m_order.size();
+    bool changed = stocks.size() != previousSize;
+    m_order.resize(stocks.size());
+
+    int row = 0;
+    for (auto it = stocks.cbegin(); it != stocks.cend(); ++it, ++row) {
+        int id = -1;
+        if (row < previousSize && m_codes[m_order[row]] == it.key()) {
+            id = m_order[row];
+        } else {
+            changed = true;
+            id = m_ids.value(it.key(), -1);
+            if (id < 0) {
+                id = m_codes.size();
+                m_ids.insert(it.key(), id);
+                m_codes.append(it.key());
+                m_rows.append(nullptr);
+            }
+            m_order[row] = id;
+        }
+        m_rows[id] = &it.value();
+    }
+
+    // 股票集合变化时重新分板块
+    if (changed) {
+        for (QVector<int>& board : m_boards) {
+            board.clear();
+        }
+        for (int id : std::as_const(m_order)) {
+            m_boards[int(m_rows[id]->getMarketType())].append(id);
+        }
+    }
+}
+
+int QuoteIndex::fill(const int *ids, int count, Fields fields, const Columns& columns) const
+{
+    const double nan = qQNaN();
+    int found = 0;
+    for (int i = 0; i < count; ++i) {
+        const StockItem *item = stock(ids[i]);
+        if (item) {
+            ++found;
+        }
+
+        if (fields & CurrentPriceField) {
+            columns.currentPrice[i] = item ? item->getCurrentPrice() : nan;
+        }
+        if (fields & OpenPriceField) {
+            columns.openPrice[i] = item ? item->getOpenPrice() : nan;
+        }
+        if (fields & HighPriceField) {
+            columns.highPrice[i] = item ? item->getHighPrice() : nan;
+        }
+        if (fields & LowPriceField) {
+            columns.lowPrice[i] = item ? item->getLowPrice() : nan;
+        }
+        if (fields & PreviousCloseField) {
+            columns.previousClose[i] = item ? item->getPreviousClose() : nan;
+        }
+        if (fields & ChangePercentField) {
+            columns.changePercent[i] = item ? item->getChangePercent() : nan;
+        }
+        if (fields & VolumeField) {
+            columns.volume[i] = item ? item->getVolume() : 0;
+        }
+        if (fields & AmountField) {
+            columns.amount[i] = item ? item->getAmount() : nan;
+        }
+    }
+    return found;
+}
+
+const QVector<int>& QuoteIndex::boardSymbols(StockItem::MarketType type) const
+{
+    return m_boards[int(type)];
+}
+
+int QuoteIndex::rankRange(Field key, Qt::SortOrder order, int first, int count, int *ids) const
+{
+    bool descending = order == Qt::DescendingOrder;
+    QVector<int>& ranking = m_ranks[int(key) * 2 + (descending ? 1 : 0)];
+    if (ranking.size() != m_order.size()) {
+        // 先按编号取出字段值，排序时不再访问股票对象
+        m_keys.resize(m_rows.size());
+        for (int id : std::as_const(m_order)) {
+            m_keys[id] = fieldValue(*m_rows[id], key);
+        }
+
+        ranking.clear();
+        ranking.append(m_order);
+        const double *keys = m_keys.constData();
+        std::sort(ranking.begin(), ranking.end(), [keys, descending](int a, int b) {
+            if (keys[a] != keys[b]) {
+                return descending ? keys[a] > keys[b] : keys[a] < keys[b];
+            }
+            return a < b;
+        });
+    }
+
+    int written = 0;
+    for (int rank = qMax(first, 0); rank < ranking.size() && written < count; ++rank) {
+        ids[written++] = ranking[rank];
+    }
+    return written;
+}
+
+double QuoteIndex::fieldValue(const StockItem& stock, Field field)
+{
+    switch (field) {
+    case CurrentPriceField:
+        return stock.getCurrentPrice();
+    case OpenPriceField:
+        return stock.getOpenPrice();
+    case HighPriceField:
+        return stock.getHighPrice();
+    case LowPriceField:
+        return stock.getLowPrice();
+    case PreviousCloseField:
+        return stock.getPreviousClose();
+    case ChangePercentField:
+        return stock.getChangePercent();
+    case VolumeField:
+        return double(stock.getVolume());
+    case AmountField:
+        return stock.getAmount();
+    default:
+        return 0.0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "marketdata.h"
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+/**
+ * @brief 行情批量查询索引
+ *
+ * 给每只股票分配一个稳定的整数编号（按首次出现的顺序，不会复用），并记录当前快照中
+ * 每个编号对应的股票。调用方按编号数组和字段掩码一次性取出多只股票的行情，写入自己提供的
+ * 连续数组；按板块和按排名的区间查询也直接返回编号，不必逐个代码查表。
+ * 每次行情更新后重建，股票集合不变时只按顺序比对代码；排名在第一次查询时计算并缓存到下次更新。
+ * 只在更新它的线程中使用
+ */
+class QuoteIndex
+{
+public:
+    /**
+     * @brief 可批量查询的字段
+     */
+    enum Field {
+        NoField = 0x00,
+        CurrentPriceField = 0x01,   // 现价
+        OpenPriceField = 0x02,      // 开盘价
+        HighPriceField = 0x04,      // 最高价
+        LowPriceField = 0x08,       // 最低价
+        PreviousCloseField = 0x10,  // 昨收价
+        ChangePercentField = 0x20,  // 涨跌幅（%）
+        VolumeField = 0x40,         // 成交量
+        AmountField = 0x80,         // 成交金额
+        AllFields = 0xFF
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+
+    /**
+     * @brief 调用方提供的输出数组，每个数组至少能容纳查询的编号数量
+     *
+     * 只写入字段掩码中的字段，其余数组可以为nullptr。
+     * 编号无效或股票不在当前快照中时，价格类字段写入NaN，成交量写入0
+     */
+    struct Columns {
+        double *currentPrice = nullptr;
+        double *openPrice = nullptr;
+        double *highPrice = nullptr;
+        double *lowPrice = nullptr;
+        double *previousClose = nullptr;
+        double *changePercent = nullptr;
+        long long *volume = nullptr;
+        double *amount = nullptr;
+    };
+
+public:
+    QuoteIndex();
+    ~QuoteIndex();
+
+    /**
+     * @brief 按新的行情快照重建索引
+     * @param data 市场数据（隐式共享，索引持有一份引用）
+     */
+    void update(const MarketData& data);
+
+    /**
+     * @brief 已分配的编号数量，编号范围为[0, symbolCount())
+     */
+    int symbolCount() const { return m_codes.size(); }
+
+    /**
+     * @brief 股票代码对应的编号
+     * @return 从未出现过的股票返回-1
+     */
+    int symbolId(const QString& code) const { return m_ids.value(code, -1); }
+
+    /**
+     * @brief 编号对应的股票代码
+     */
+    QString symbolCode(int id) const { return id >= 0 && id < m_codes.size() ? m_codes[id] : QString(); }
+
+    /**
+     * @brief 编号对应的股票
+     * @return 不在当前快照中时返回nullptr；指针在下次update前有效
+     */
+    const StockItem* stock(int id) const { return id >= 0 && id < m_rows.size() ? m_rows[id] : nullptr; }
+
+    /**
+     * @brief 批量读取行情字段
+     * @param ids 股票编号数组
+     * @param count 编号数量
+     * @param fields 需要的字段
+     * @param columns 输出数组，第i个元素对应ids[i]
+     * @return 在当前快照中找到的股票数量
+     */
+    int fill(const int *ids, int count, Fields fields, const Columns& columns) const;
+
+    /**
+     * @brief 当前快照中指定板块的股票编号，按代码排序
+     * @param type 市场类型
+     */
+    const QVector<int>& boardSymbols(StockItem::MarketType type) const;
+
+    /**
+     * @brief 按字段排名的区间查询
+     *
+     * 排名相同时编号小的在前
+     * @param key 排序字段（单个字段）
+     * @param order 升序或降序
+     * @param first 第一个名次（从0开始）
+     * @param count 最多返回的数量
+     * @param ids 输出的股票编号，至少能容纳count个
+     * @return 实际写入的数量
+     */
+    int rankRange(Field key, Qt::SortOrder order, int first, int count, int *ids) const;
+
+private:
+    /**
+     * @brief 股票的字段值
+     */
+    static double fieldValue(const StockItem& stock, Field field);
+
+private:
+    static const int kBoardCount = int(StockItem::MarketType::StarMarket) + 1;
+
+    MarketData m_data;                       // 当前快照
+    QHash<QString, int> m_ids;               // 股票代码 -> 编号
+    QVector<QString> m_codes;                // 编号 -> 股票代码
+    QVector<const StockItem*> m_rows;        // 编号 -> 当前快照中的股票，不在快照中时为nullptr
+    QVector<int> m_order;                    // 快照中的股票编号，按代码排序
+    QVector<int> m_boards[kBoardCount];      // 各板块的股票编号
+
+    // 按字段和排序方向缓存的排名，行情更新时清空
+    mutable QHash<int, QVector<int>> m_ranks;
+    mutable QVector<double> m_keys;          // 计算排名时复用的字段值缓冲区
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QuoteIndex::Fields)
\ No newline at end of file
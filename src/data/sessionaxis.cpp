@@ -0,0 +1,87 @@
+#include "sessionaxis.h"
+#include "tradingcalendar.h"
+
+namespace {
+
+const int kMorningOpen = TradingCalendar::kMorningOpen;
+const int kMorningClose = TradingCalendar::kMorningClose;
+const int kAfternoonOpen = TradingCalendar::kAfternoonOpen;
+const int kAfternoonClose = TradingCalendar::kAfternoonClose;
+const int kMorningMinutes = kMorningClose - kMorningOpen;
+
+/**
+ * @brief 一天1440分钟到交易分钟序号的查找表
+ */
+QVector<int> buildMinuteTable()
+{
+    QVector<int> table(24 * 60, -1);
+    for (int minute = kMorningOpen; minute <= kMorningClose; ++minute) {
+        table[minute] = qMin(minute - kMorningOpen, kMorningMinutes - 1);
+    }
+    for (int minute = kAfternoonOpen; minute <= kAfternoonClose; ++minute) {
+        table[minute] = kMorningMinutes + qMin(minute - kAfternoonOpen, SessionAxis::kMinutesPerDay - kMorningMinutes - 1);
+    }
+    return table;
+}
+
+} // namespace
+
+SessionAxis::SessionAxis()
+{
+}
+
+SessionAxis::~SessionAxis()
+{
+}
+
+void SessionAxis::setDays(const QVector<QDate>& days)
+{
+    m_days = days;
+    m_dayIndex.clear();
+    m_dayIndex.reserve(days.size());
+    for (int i = 0; i < days.size(); ++i) {
+        m_dayIndex.insert(days[i].toJulianDay(), i);
+    }
+}
+
+int SessionAxis::position(const QDateTime& time) const
+{
+    // 交易日和交易分钟按上海时间判断，与时间戳所带的时区无关
+    QDateTime exchangeTime = time.toTimeZone(TradingCalendar::timeZone());
+
+    auto it = m_dayIndex.constFind(exchangeTime.date().toJulianDay());
+    if (it == m_dayIndex.constEnd()) {
+        return -1;
+    }
+
+    int minute = sessionMinute(exchangeTime.time());
+    if (minute < 0) {
+        return -1;
+    }
+    return it.value() * kMinutesPerDay + minute;
+}
+
+QDateTime SessionAxis::timeAt(int position) const
+{
+    if (position < 0 || position >= size()) {
+        return QDateTime();
+    }
+    return QDateTime(m_days[position / kMinutesPerDay], minuteTime(position % kMinutesPerDay),
+                     TradingCalendar::timeZone());
+}
+
+int SessionAxis::sessionMinute(const QTime& time)
+{
+    static const QVector<int> table = buildMinuteTable();
+    if (!time.isValid()) {
+        return -1;
+    }
+    return table[time.hour() * 60 + time.minute()];
+}
+
+QTime SessionAxis::minuteTime(int minute)
+{
+    int minuteOfDay = minute < kMorningMinutes ? kMorningOpen + minute
+                                               : kAfternoonOpen + minute - kMorningMinutes;
+    return QTime(minuteOfDay / 60, minuteOfDay % 60);
+}
\ No newline at end of file
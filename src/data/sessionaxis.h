@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief 按交易时段压缩的分时坐标轴
+ *
+ * 把若干交易日的交易分钟映射为连续的整数位置：每天kMinutesPerDay个位置，
+ * 9:30-11:30映射为0~119，13:00-15:00映射为120~239，午休和隔夜不占位置。
+ * 交易时段和时区取自TradingCalendar，时间一律换算为上海时间，交易日由调用者按交易日历给出。
+ * 一天内的分钟由预先计算的查找表换算，交易日由哈希表换算，
+ * 时间与位置的相互换算都是O(1)
+ */
+class SessionAxis
+{
+public:
+    static const int kMinutesPerDay = 240;  // 每个交易日的交易分钟数
+
+    SessionAxis();
+    ~SessionAxis();
+
+    /**
+     * @brief 设置坐标轴包含的交易日
+     * @param days 交易日，按日期升序
+     */
+    void setDays(const QVector<QDate>& days);
+
+    /**
+     * @brief 坐标轴包含的交易日
+     */
+    const QVector<QDate>& days() const { return m_days; }
+
+    /**
+     * @brief 交易日数量
+     */
+    int dayCount() const { return m_days.size(); }
+
+    /**
+     * @brief 位置总数
+     */
+    int size() const { return m_days.size() * kMinutesPerDay; }
+
+    /**
+     * @brief 时间对应的位置
+     * @param time 时间
+     * @return 位置，不在坐标轴的交易时段内时返回-1
+     */
+    int position(const QDateTime& time) const;
+
+    /**
+     * @brief 位置对应的时间（该交易分钟的开始）
+     * @param position 位置
+     * @return 上海时间，位置越界时返回无效时间
+     */
+    QDateTime timeAt(int position) const;
+
+    /**
+     * @brief 一天内的交易分钟序号
+     * @param time 时刻
+     * @return 0~239，11:30和15:00归入前一分钟，非交易时间返回-1
+     */
+    static int sessionMinute(const QTime& time);
+
+    /**
+     * @brief 交易分钟序号对应的时刻
+     * @param minute 交易分钟序号（0~239）
+     */
+    static QTime minuteTime(int minute);
+
+private:
+    QVector<QDate> m_days;           // 交易日，按日期升序
+    QHash<qint64, int> m_dayIndex;   // 儒略日 -> 交易日下标
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "stockitem.h"
+#include "symboltable.h"
+#include <QtMath>
 
 StockItem::StockItem()
     : m_marketType(MarketType::Unknown)
@@ -9,12 +11,15 @@ StockItem::StockItem()
     , m_previousClose(0.0)
     , m_volume(0)
     , m_amount(0.0)
+    , m_hasCurrentMinute(false)
+    , m_timeSeriesAmount(0.0)
+    , m_timeSeriesVolume(0)
 {
 }
 
 StockItem::StockItem(const QString& code, const QString& name)
     : m_code(code)
-    , m_name(name)
+    , m_name(SymbolTable::intern(code, name))
     , m_marketType(MarketType::Unknown)
     , m_currentPrice(0.0)
     , m_openPrice(0.0)
@@ -23,6 +28,9 @@ StockItem::StockItem(const QString& code, const QString& name)
     , m_previousClose(0.0)
     , m_volume(0)
     , m_amount(0.0)
+    , m_hasCurrentMinute(false)
+    , m_timeSeriesAmount(0.0)
+    , m_timeSeriesVolume(0)
 {
     // 根据股票代码判断市场类型
     if (code.startsWith("60")) {
@@ -40,6 +48,22 @@ StockItem::~StockItem()
 {
 }
 
+void StockItem::setCode(const QString& code)
+{
+    // 先设置名称后设置代码时，名称此时登记；更换代码时改用新代码登记的名称
+    QString name = m_code.isEmpty() ? m_name : QString();
+    m_code = code;
+    if (!m_code.isEmpty()) {
+        m_name = SymbolTable::intern(m_code, name);
+    }
+}
+
+void StockItem::setName(const QString& name)
+{
+    // 还没有代码时先保存，设置代码时再登记
+    m_name = m_code.isEmpty() ? name : SymbolTable::intern(m_code, name);
+}
+
 double StockItem::getChange() const
 {
     return m_currentPrice - m_previousClose;
@@ -52,4 +76,83 @@ double StockItem::getChangePercent() const
     }
     
     return (m_currentPrice - m_previousClose) / m_previousClose * 100.0;
-} 
\ No newline at end of file
+}
+
+double StockItem::getLimitRatio() const
+{
+    switch (m_marketType) {
+    case MarketType::ChiNext:
+    case MarketType::StarMarket:
+        return 0.20;
+    default:
+        return 0.10;
+    }
+}
+
+double StockItem::getLimitUpPrice() const
+{
+    // 按分四舍五入
+    return qRound(m_previousClose * (1.0 + getLimitRatio()) * 100.0) / 100.0;
+}
+
+double StockItem::getLimitDownPrice() const
+{
+    return qRound(m_previousClose * (1.0 - getLimitRatio()) * 100.0) / 100.0;
+}
+
+QVector<TimeSeriesPoint> StockItem::getTimeSeriesData() const
+{
+    if (!m_hasCurrentMinute) {
+        return m_timeSeriesData;
+    }
+    
+    QVector<TimeSeriesPoint> data;
+    data.reserve(m_timeSeriesData.size() + 1);
+    data += m_timeSeriesData;
+    data.append(m_currentMinute);
+    return data;
+}
+
+void StockItem::addTimeSeriesPoint(const TimeSeriesPoint& point)
+{
+    // 上一分钟收盘，放入共享的分时数据；与快照共享时每分钟只分离这一次
+    if (m_hasCurrentMinute) {
+        m_timeSeriesData.append(m_currentMinute);
+    }
+    
+    m_timeSeriesAmount += point.price * point.volume;
+    m_timeSeriesVolume += point.volume;
+    
+    m_currentMinute = point;
+    m_currentMinute.averagePrice = m_timeSeriesVolume > 0 ? m_timeSeriesAmount / m_timeSeriesVolume : point.price;
+    m_hasCurrentMinute = true;
+}
+
+void StockItem::updateLastTimeSeriesPoint(double price, long long volume)
+{
+    if (!m_hasCurrentMinute) {
+        return;
+    }
+    
+    // 本笔成交按成交价计入累计成交额，不按最新价重估这一分钟已有的成交
+    TimeSeriesPoint& last = m_currentMinute;
+    m_timeSeriesAmount += price * volume;
+    m_timeSeriesVolume += volume;
+    
+    last.price = price;
+    last.volume += volume;
+    last.averagePrice = m_timeSeriesVolume > 0 ? m_timeSeriesAmount / m_timeSeriesVolume : price;
+}
+
+void StockItem::setTimeSeriesData(const QVector<TimeSeriesPoint>& data)
+{
+    m_timeSeriesData.clear();
+    m_timeSeriesData.reserve(data.size());
+    m_hasCurrentMinute = false;
+    m_timeSeriesAmount = 0.0;
+    m_timeSeriesVolume = 0;
+    
+    for (const TimeSeriesPoint& point : data) {
+        addTimeSeriesPoint(point);
+    }
+}
\ No newline at end of file
@@ -26,8 +26,9 @@ struct TimeSeriesPoint {
     QDateTime timestamp;  // 时间戳
     double price;         // 价格
     long long volume;     // 成交量
+    double averagePrice;  // 均价（开盘至该分钟的成交量加权平均价），由StockItem维护
     
-    TimeSeriesPoint() : price(0), volume(0) {}
+    TimeSeriesPoint() : price(0), volume(0), averagePrice(0) {}
 };
 
 /**
@@ -53,12 +54,14 @@ public:
     ~StockItem();
     
     // 基本信息
+    // 名称登记在SymbolTable中，对象只保存登记时取得的共享句柄，读取时不查表
     QString getCode() const { return m_code; }
     QString getName() const { return m_name; }
     MarketType getMarketType() const { return m_marketType; }
     
-    void setCode(const QString& code) { m_code = code; }
-    void setName(const QString& name) { m_name = name; }
+    // 先设置名称后设置代码时，名称在设置代码时登记
+    void setCode(const QString& code);
+    void setName(const QString& name);
     void setMarketType(MarketType type) { m_marketType = type; }
     
     // 当前价格信息
@@ -85,15 +88,32 @@ public:
     double getChange() const;
     double getChangePercent() const;
     
+    // 涨跌停价（主板10%，创业板、科创板20%）
+    double getLimitRatio() const;
+    double getLimitUpPrice() const;
+    double getLimitDownPrice() const;
+    
     // 历史K线数据
     const QVector<StockTradeData>& getKLineData() const { return m_kLineData; }
     void addKLineData(const StockTradeData& data) { m_kLineData.append(data); }
     void setKLineData(const QVector<StockTradeData>& data) { m_kLineData = data; }
     
     // 分时数据
-    const QVector<TimeSeriesPoint>& getTimeSeriesData() const { return m_timeSeriesData; }
-    void addTimeSeriesPoint(const TimeSeriesPoint& point) { m_timeSeriesData.append(point); }
-    void setTimeSeriesData(const QVector<TimeSeriesPoint>& data) { m_timeSeriesData = data; }
+    // 最后一个点（当前分钟）单独存放，逐笔更新它不会使与快照共享的已收盘分钟分离；
+    // 逐点读取用getTimeSeriesCount/getTimeSeriesPoint，getTimeSeriesData拼出完整副本，只在完整重建时使用
+    QVector<TimeSeriesPoint> getTimeSeriesData() const;
+    const QVector<TimeSeriesPoint>& getClosedTimeSeriesData() const { return m_timeSeriesData; }
+    int getTimeSeriesCount() const { return m_timeSeriesData.size() + (m_hasCurrentMinute ? 1 : 0); }
+    const TimeSeriesPoint& getTimeSeriesPoint(int index) const
+    {
+        return index < m_timeSeriesData.size() ? m_timeSeriesData[index] : m_currentMinute;
+    }
+    const TimeSeriesPoint& getLastTimeSeriesPoint() const { return getTimeSeriesPoint(getTimeSeriesCount() - 1); }
+    // 追加时按累计成交额和成交量在O(1)内计算均价，上一个点此时收盘
+    void addTimeSeriesPoint(const TimeSeriesPoint& point);
+    // 当前分钟内的成交累加到最后一个点上，价格取最新价，均价同样O(1)更新
+    void updateLastTimeSeriesPoint(double price, long long volume);
+    void setTimeSeriesData(const QVector<TimeSeriesPoint>& data);
     
     // 更新时间
     QDateTime getUpdateTime() const { return m_updateTime; }
@@ -102,7 +122,7 @@ public:
 private:
     // 股票基本信息
     QString m_code;                          // 股票代码
-    QString m_name;                          // 股票名称
+    QString m_name;                          // 股票名称（SymbolTable中登记的共享句柄）
     MarketType m_marketType;                 // 市场类型
     
     // 当前价格信息
@@ -120,7 +140,11 @@ private:
     QVector<StockTradeData> m_kLineData;     // K线历史数据
     
     // 分时数据
-    QVector<TimeSeriesPoint> m_timeSeriesData; // 分时数据
+    QVector<TimeSeriesPoint> m_timeSeriesData; // 已收盘的分时数据
+    TimeSeriesPoint m_currentMinute;         // 当前分钟（最后一个分时点）
+    bool m_hasCurrentMinute;                 // 是否已有分时点
+    double m_timeSeriesAmount;               // 分时累计成交额（均价用）
+    long long m_timeSeriesVolume;            // 分时累计成交量
     
     // 更新时间
     QDateTime m_updateTime;                  // 数据更新时间
@@ -0,0 +1,258 @@
+#include "symbolindex.h"
+#include <QHash>
+#include <QMap>
+#include <algorithm>
+
+namespace {
+
+// 构建阶段使用的临时节点
+struct BuildNode {
+    QMap<char16_t, int> children;  // 子节点（按字符排序）
+    QVector<int> terminals;        // 以该节点结尾的条目
+};
+
+/**
+ * @brief 常用汉字拼音首字母表
+ *
+ * 覆盖沪深两市证券简称中的常用汉字，多音字按证券简称中的读音归类
+ */
+const QHash<char16_t, char>& pinyinTable()
+{
+    static const QHash<char16_t, char> table = [] {
+        static const struct {
+            char letter;
+            const char16_t *chars;
+        } groups[] = {
+            {'A', u"安鞍氨艾爱奥澳昂阿"},
+            {'B', u"北百宝保包邦博波渤滨彬斌标表宾兵并八白柏半版板办帮榜报备贝本比必碧边变便别冰步部布"},
+            {'C', u"成长城创诚春川昌超车晨辰朝潮彩财材采参仓苍草策层测茶产常场厂畅巢陈承乘程驰池赤崇冲出初储楚传船窗纯词慈此从聪丛翠村存"},
+            {'D', u"大电东达德迪丹道地第点典店顶鼎定动都斗豆独度渡端段锻对多敦盾顿的"},
+            {'E', u"二尔恩鄂"},
+            {'F', u"发方飞丰福富复凤峰锋枫风封蜂法帆番繁泛范防房纺放非菲肥分芬粉奋份佛夫服浮符府辅父付负附赋"},
+            {'G', u"国广港光高工股冠钢格谷古固鼓故关观管贵桂果过改盖干甘赣刚岗纲歌葛给根更耿功宫公供共沟构购估骨顾瓜官惯灌规硅轨柜滚锅"},
+            {'H', u"华海恒宏鸿虹红弘航杭合和河核贺黑亨横衡汉翰豪浩好号禾何荷赫鹤后厚呼湖虎互户沪花化划画话怀环寰欢换焕皇黄煌辉徽回汇会惠慧火伙货获行"},
+            {'J', u"金建江京嘉佳捷杰晶精锦进九久酒吉集机基济冀加家甲价驾坚兼监检剑健舰将疆讲匠交郊胶焦角教较阶接街节洁结界借今津近劲晋经井景警净竞静境镜居巨句聚决均君俊骏峻际"},
+            {'K', u"科康凯开卡克可客空控口库快宽矿昆坤扩"},
+            {'L', u"联力利立丽良亮龙隆路鲁陆绿铝伦轮罗洛蓝兰朗浪劳乐雷蕾冷黎理礼里历励连莲廉链凉粮两辽林临灵玲凌菱岭领流柳六楼芦鹿禄旅律率"},
+            {'M', u"美明民茂梅煤迈麦满曼猫毛贸玫媒门蒙梦米密棉面苗妙敏名铭模摩牧木目沐茅"},
+            {'N', u"南能宁农牛纽诺纳耐内尼年鸟凝"},
+            {'O', u"欧鸥"},
+            {'P', u"平浦鹏派盘沛培配彭蓬披皮片飘品聘屏坡葡普朴"},
+            {'Q', u"青清庆全泉强桥琴勤秦启奇齐祁旗企起气汽器千前钱潜浅乔巧切亲轻氢晴擎琼秋球区曲趋渠权劝券确群"},
+            {'R', u"荣融瑞润日仁人任锐睿容柔如汝乳软"},
+            {'S', u"上深山申世生盛胜森沙莎三桑色善商尚绍舍设社神沈升声圣师诗十石时实食史士市示事势视试室适首寿授书舒数双水顺硕思斯四松苏素速塑酸随穗孙损所索"},
+            {'T', u"天通同泰太台唐塔钛坦汤堂糖特腾提体田铁听亭庭停桐铜统投图途土团推拓"},
+            {'W', u"万文五武伟威卫维物王网旺望微为唯尾味温稳沃无吴梧午务雾"},
+            {'X', u"新信兴星鑫祥湘厦西希锡熙喜系细峡下夏先仙鲜贤现线宪县香翔向项象小晓效协鞋心欣形型幸雄修秀须徐许旭宣轩选学雪讯迅芯"},
+            {'Y', u"银亿益远越云粤阳洋扬杨药业一伊医依仪宜移以艺易意毅翼因音引印英赢盈营影应永勇用优油友有佑于余鱼宇羽雨语玉育浴预裕元园原源圆院月悦跃运韵液"},
+            {'Z', u"中证招浙重众智卓紫资自综钻尊正振真珍郑政之支芝知直植指至志制质治致置忠钟种州洲舟珠诸竹主驻著筑专转庄装壮状追准子字宗总纵走租足组祖嘴最遵左作座泽张章掌丈兆照哲针震镇征整"}
+        };
+
+        QHash<char16_t, char> result;
+        for (const auto& group : groups) {
+            for (const char16_t *p = group.chars; *p; ++p) {
+                if (!result.contains(*p)) {
+                    result.insert(*p, group.letter);
+                }
+            }
+        }
+        return result;
+    }();
+
+    return table;
+}
+
+/**
+ * @brief 前序遍历，为每个节点分配子树在结果数组中的区间
+ */
+void layoutPostings(const QVector<BuildNode>& tree, int node,
+                    QVector<int>& postings, QVector<int>& begin, QVector<int>& end)
+{
+    begin[node] = postings.size();
+    postings.append(tree[node].terminals);
+
+    for (auto it = tree[node].children.cbegin(); it != tree[node].children.cend(); ++it) {
+        layoutPostings(tree, it.value(), postings, begin, end);
+    }
+
+    end[node] = postings.size();
+}
+
+} // namespace
+
+SymbolIndex::SymbolIndex()
+{
+}
+
+SymbolIndex::~SymbolIndex()
+{
+}
+
+void SymbolIndex::build(const MarketData& marketData)
+{
+    m_entries.clear();
+    m_nodes.clear();
+    m_postings.clear();
+
+    const QMap<QString, StockItem>& stocks = marketData.getAllStocks();
+    m_entries.reserve(stocks.size());
+
+    QVector<BuildNode> tree(1);
+
+    auto insert = [&tree](const QString& key, int entryIndex) {
+        int node = 0;
+        for (QChar c : key) {
+            auto it = tree[node].children.constFind(c.unicode());
+            if (it != tree[node].children.cend()) {
+                node = it.value();
+            } else {
+                int child = tree.size();
+                tree[node].children.insert(c.unicode(), child);
+                tree.append(BuildNode());
+                node = child;
+            }
+        }
+
+        if (!tree[node].terminals.contains(entryIndex)) {
+            tree[node].terminals.append(entryIndex);
+        }
+    };
+
+    // 代码、名称、拼音首字母三种键都指向同一个条目
+    for (auto it = stocks.cbegin(); it != stocks.cend(); ++it) {
+        Entry entry;
+        entry.code = it.key();
+        entry.name = it.value().getName();
+        entry.initials = pinyinInitials(entry.name);
+
+        int entryIndex = m_entries.size();
+        insert(normalizeKey(entry.code), entryIndex);
+        insert(normalizeKey(entry.name), entryIndex);
+        if (!entry.initials.isEmpty()) {
+            insert(entry.initials, entryIndex);
+        }
+
+        m_entries.append(entry);
+    }
+
+    // 计算每个节点的结果区间
+    QVector<int> postBegin(tree.size());
+    QVector<int> postEnd(tree.size());
+    layoutPostings(tree, 0, m_postings, postBegin, postEnd);
+
+    // 按层序展开节点，使同一父节点的子节点连续存放
+    m_nodes.resize(tree.size());
+    QVector<int> order;
+    order.reserve(tree.size());
+    order.append(0);
+
+    m_nodes[0].ch = 0;
+    int next = 1;
+    for (int i = 0; i < order.size(); ++i) {
+        const BuildNode& source = tree[order[i]];
+        Node& node = m_nodes[i];
+
+        node.childBegin = next;
+        for (auto it = source.children.cbegin(); it != source.children.cend(); ++it) {
+            m_nodes[next].ch = it.key();
+            order.append(it.value());
+            ++next;
+        }
+        node.childEnd = next;
+        node.postBegin = postBegin[order[i]];
+        node.postEnd = postEnd[order[i]];
+    }
+}
+
+bool SymbolIndex::matches(const MarketData& marketData) const
+{
+    const QMap<QString, StockItem>& stocks = marketData.getAllStocks();
+    if (stocks.size() != m_entries.size()) {
+        return false;
+    }
+
+    int i = 0;
+    for (auto it = stocks.cbegin(); it != stocks.cend(); ++it, ++i) {
+        if (it.key() != m_entries[i].code) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QVector<int> SymbolIndex::search(const QString& prefix, int limit) const
+{
+    QVector<int> results;
+
+    QString key = normalizeKey(prefix);
+    if (key.isEmpty() || m_nodes.isEmpty() || limit <= 0) {
+        return results;
+    }
+
+    // 沿前缀向下查找
+    int node = 0;
+    for (QChar c : key) {
+        node = findChild(node, c.unicode());
+        if (node < 0) {
+            return results;
+        }
+    }
+
+    // 子树区间内的条目即为全部匹配结果，同一条目可能通过多个键命中，需要去重
+    const Node& found = m_nodes[node];
+    for (int i = found.postBegin; i < found.postEnd && results.size() < limit; ++i) {
+        int entryIndex = m_postings[i];
+        if (!results.contains(entryIndex)) {
+            results.append(entryIndex);
+        }
+    }
+
+    return results;
+}
+
+QString SymbolIndex::pinyinInitials(const QString& text)
+{
+    const QHash<char16_t, char>& table = pinyinTable();
+
+    QString initials;
+    initials.reserve(text.size());
+
+    for (QChar c : text) {
+        if (c.unicode() < 128) {
+            // 名称中的英文字母和数字（如"TCL"、"ST"）直接保留
+            if (c.isLetterOrNumber()) {
+                initials.append(c.toUpper());
+            }
+            continue;
+        }
+
+        auto it = table.constFind(c.unicode());
+        if (it != table.cend()) {
+            initials.append(QLatin1Char(it.value()));
+        }
+    }
+
+    return initials;
+}
+
+int SymbolIndex::findChild(int node, char16_t ch) const
+{
+    const Node *first = m_nodes.constData() + m_nodes[node].childBegin;
+    const Node *last = m_nodes.constData() + m_nodes[node].childEnd;
+
+    const Node *it = std::lower_bound(first, last, ch, [](const Node& n, char16_t value) {
+        return n.ch < value;
+    });
+
+    if (it == last || it->ch != ch) {
+        return -1;
+    }
+
+    return int(it - m_nodes.constData());
+}
+
+QString SymbolIndex::normalizeKey(const QString& key)
+{
+    return key.trimmed().toUpper();
+}
\ No newline at end of file
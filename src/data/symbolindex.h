@@ -0,0 +1,94 @@
+#pragma once
+
+#include "marketdata.h"
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 证券代码前缀索引类（键盘精灵）
+ *
+ * 将股票代码、名称和拼音首字母压缩存储在一棵前缀树中，
+ * 每个节点对应结果数组中的一段连续区间，查询只需沿前缀走一遍即可得到结果
+ */
+class SymbolIndex
+{
+public:
+    /**
+     * @brief 索引条目
+     */
+    struct Entry {
+        QString code;      // 股票代码
+        QString name;      // 股票名称
+        QString initials;  // 拼音首字母
+    };
+
+public:
+    SymbolIndex();
+    ~SymbolIndex();
+
+    /**
+     * @brief 根据市场数据重建索引
+     * @param marketData 市场数据
+     */
+    void build(const MarketData& marketData);
+
+    /**
+     * @brief 判断索引是否与市场数据中的股票集合一致
+     * @param marketData 市场数据
+     * @return 一致返回true，此时无需重建
+     */
+    bool matches(const MarketData& marketData) const;
+
+    /**
+     * @brief 按前缀查询
+     * @param prefix 输入的前缀（代码、名称或拼音首字母，不区分大小写）
+     * @param limit 最多返回的结果数
+     * @return 匹配条目的下标列表
+     */
+    QVector<int> search(const QString& prefix, int limit) const;
+
+    /**
+     * @brief 获取索引条目
+     * @param index 条目下标
+     * @return 条目引用
+     */
+    const Entry& entry(int index) const { return m_entries[index]; }
+
+    /**
+     * @brief 获取条目数量
+     */
+    int size() const { return m_entries.size(); }
+
+    /**
+     * @brief 计算文本的拼音首字母
+     * @param text 文本（一般为股票名称）
+     * @return 大写拼音首字母，无法识别的汉字会被跳过
+     */
+    static QString pinyinInitials(const QString& text);
+
+private:
+    // 前缀树节点，子节点按字符排序连续存放，便于二分查找
+    struct Node {
+        char16_t ch;       // 边上的字符
+        int childBegin;    // 第一个子节点下标
+        int childEnd;      // 最后一个子节点下标+1
+        int postBegin;     // 子树结果区间起点
+        int postEnd;       // 子树结果区间终点
+    };
+
+    /**
+     * @brief 在子节点中二分查找字符
+     * @return 子节点下标，不存在返回-1
+     */
+    int findChild(int node, char16_t ch) const;
+
+    /**
+     * @brief 规范化查询键（转为大写）
+     */
+    static QString normalizeKey(const QString& key);
+
+private:
+    QVector<Entry> m_entries;   // 索引条目
+    QVector<Node> m_nodes;      // 前缀树节点（0为根节点）
+    QVector<int> m_postings;    // 按前序遍历排列的条目下标
+};
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "symboltable.h"
+#include <QHash>
+#include <QReadWriteLock>
+
+namespace {
+
+QReadWriteLock g_lock;
+QHash<QString, QString> g_names;  // 股票代码 -> 名称
+
+} // namespace
+
+QString SymbolTable::intern(const QString& code, const QString& name)
+{
+    if (code.isEmpty()) {
+        return QString();
+    }
+
+    // 已登记且名称不变时只加读锁，返回登记的那一份
+    {
+        QReadLocker locker(&g_lock);
+        auto it = g_names.constFind(code);
+        if (it != g_names.constEnd() && (name.isEmpty() || it.value() == name)) {
+            return it.value();
+        }
+    }
+
+    if (name.isEmpty()) {
+        return QString();
+    }
+
+    QWriteLocker locker(&g_lock);
+    g_names.insert(code, name);
+    return name;
+}
+
+QString SymbolTable::name(const QString& code)
+{
+    QReadLocker locker(&g_lock);
+    return g_names.value(code);
+}
+
+int SymbolTable::size()
+{
+    QReadLocker locker(&g_lock);
+    return g_names.size();
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief 证券名称表
+ *
+ * 股票名称等不变的参考字符串按代码登记一次，同一代码的所有StockItem共享登记的那一份数据，
+ * 对象只保存登记时返回的共享句柄，读取名称不需要查表和加锁。
+ * 读写加锁，可在任意线程访问
+ */
+class SymbolTable
+{
+public:
+    /**
+     * @brief 登记股票名称
+     * @param code 股票代码
+     * @param name 股票名称，为空时只查询
+     * @return 登记的名称（同一代码共享同一份数据），未登记时为空
+     */
+    static QString intern(const QString& code, const QString& name);
+
+    /**
+     * @brief 查询股票名称
+     * @param code 股票代码
+     * @return 登记的名称（与登记时共享同一份数据），未登记时为空
+     */
+    static QString name(const QString& code);
+
+    /**
+     * @brief 已登记的股票数量
+     */
+    static int size();
+};
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 一条跟踪记录
+ */
+struct TraceEvent {
+    const char *name = nullptr;  // 名称
+    qint64 start = 0;            // 开始时间（纳秒）
+    qint64 duration = 0;         // 耗时（纳秒）
+};
+
+/**
+ * @brief 使用过缓冲区的一个线程
+ */
+struct TraceOwner {
+    quint64 begin = 0;           // 该线程的第一条记录在缓冲区中的累计序号
+    int threadId = 0;            // 导出用的线程编号
+    QString threadName;          // 线程名称
+};
+
+/**
+ * @brief 环形缓冲区，同一时刻只属于一个线程
+ *
+ * 只有所属线程写入，导出时才会被其他线程读取，互斥锁基本没有竞争。
+ * 线程退出后缓冲区交给之后新建的线程继续写入，旧线程的记录在被覆盖前仍然可以导出
+ */
+struct TraceBuffer {
+    std::mutex mutex;
+    QVector<TraceEvent> events;  // 环形缓冲区
+    quint64 written = 0;         // 累计写入数
+    QVector<TraceOwner> owners;  // 先后使用该缓冲区的线程，按begin升序
+};
+
+/**
+ * @brief 所有缓冲区
+ *
+ * 缓冲区数量不超过同时在跟踪的线程数，频繁创建和结束线程时内存不会增长
+ */
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;      // 全部缓冲区，导出用
+    std::vector<std::shared_ptr<TraceBuffer>> freeBuffers;  // 所属线程已退出的缓冲区
+    std::atomic<bool> enabled{true};
+    int nextThreadId = 1;
+};
+
+TraceRegistry& registry()
+{
+    static TraceRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief 线程持有的缓冲区，线程退出时把缓冲区放回空闲列表
+ */
+class LocalBuffer
+{
+public:
+    ~LocalBuffer()
+    {
+        if (m_buffer) {
+            TraceRegistry& traces = registry();
+            std::lock_guard<std::mutex> lock(traces.mutex);
+            traces.freeBuffers.push_back(std::move(m_buffer));
+        }
+    }
+
+    TraceBuffer& get()
+    {
+        if (!m_buffer) {
+            acquire();
+        }
+        return *m_buffer;
+    }
+
+private:
+    void acquire()
+    {
+        QString threadName;
+        QThread *thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            threadName = "main";
+        } else if (thread) {
+            threadName = thread->objectName();
+        }
+
+        // 优先复用已退出线程的缓冲区
+        TraceRegistry& traces = registry();
+        std::lock_guard<std::mutex> lock(traces.mutex);
+        if (!traces.freeBuffers.empty()) {
+            m_buffer = std::move(traces.freeBuffers.back());
+            traces.freeBuffers.pop_back();
+        } else {
+            m_buffer = std::make_shared<TraceBuffer>();
+            m_buffer->events.resize(Tracer::kBufferCapacity);
+            traces.buffers.push_back(m_buffer);
+        }
+
+        TraceOwner owner;
+        owner.threadId = traces.nextThreadId++;
+        owner.threadName = threadName.isEmpty() ? QString("thread %1").arg(owner.threadId) : threadName;
+
+        std::lock_guard<std::mutex> bufferLock(m_buffer->mutex);
+        owner.begin = m_buffer->written;
+
+        // 记录已全部被覆盖的旧线程不再保留
+        quint64 oldest = m_buffer->written - qMin<quint64>(m_buffer->written, Tracer::kBufferCapacity);
+        while (m_buffer->owners.size() > 1 && m_buffer->owners[1].begin <= oldest) {
+            m_buffer->owners.removeFirst();
+        }
+        if (!m_buffer->owners.isEmpty() && m_buffer->owners.last().begin == owner.begin) {
+            m_buffer->owners.removeLast();
+        }
+        m_buffer->owners.append(owner);
+    }
+
+private:
+    std::shared_ptr<TraceBuffer> m_buffer;
+};
+
+TraceBuffer& localBuffer()
+{
+    thread_local LocalBuffer buffer;
+    return buffer.get();
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enabled)
+{
+    registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+qint64 Tracer::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(const char *name, qint64 start, qint64 end)
+{
+    TraceBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    TraceEvent& event = buffer.events[int(buffer.written % kBufferCapacity)];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    ++buffer.written;
+}
+
+bool Tracer::exportChromeTrace(const QString& path)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+
+    for (const std::shared_ptr<TraceBuffer>& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        // 从最旧的记录开始，每条记录归属于写入时持有缓冲区的线程
+        quint64 count = qMin<quint64>(buffer->written, kBufferCapacity);
+        quint64 oldest = buffer->written - count;
+        for (int n = 0; n < buffer->owners.size(); ++n) {
+            const TraceOwner& owner = buffer->owners[n];
+            quint64 begin = qMax(owner.begin, oldest);
+            quint64 end = n + 1 < buffer->owners.size() ? buffer->owners[n + 1].begin : buffer->written;
+            if (begin >= end && n + 1 < buffer->owners.size()) {
+                continue;
+            }
+
+            // 线程名称元数据
+            QJsonObject threadName;
+            threadName["name"] = "thread_name";
+            threadName["ph"] = "M";
+            threadName["pid"] = pid;
+            threadName["tid"] = owner.threadId;
+            threadName["args"] = QJsonObject{{"name", owner.threadName}};
+            traceEvents.append(threadName);
+
+            for (quint64 i = begin; i < end; ++i) {
+                const TraceEvent& event = buffer->events[int(i % kBufferCapacity)];
+
+                QJsonObject object;
+                object["name"] = QString::fromLatin1(event.name);
+                object["cat"] = "quote";
+                object["ph"] = "X";
+                object["ts"] = event.start / 1000.0;
+                object["dur"] = event.duration / 1000.0;
+                object["pid"] = pid;
+                object["tid"] = owner.threadId;
+                traceEvents.append(object);
+            }
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+void Tracer::clear()
+{
+    TraceRegistry& traces = registry();
+    std::lock_guard<std::mutex> registryLock(traces.mutex);
+
+    for (const std::shared_ptr<TraceBuffer>& buffer : traces.buffers) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->written = 0;
+
+        // 只保留当前（或最后）持有缓冲区的线程
+        if (buffer->owners.size() > 1) {
+            buffer->owners.remove(0, buffer->owners.size() - 1);
+        }
+        for (TraceOwner& owner : buffer->owners) {
+            owner.begin = 0;
+        }
+    }
+}
\ No newline at end of file
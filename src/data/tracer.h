@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief 性能跟踪
+ *
+ * 用TRACE_SCOPE("名称")标记一段代码，离开作用域时把起止时间记入当前线程的环形缓冲区；
+ * 每个线程一个缓冲区，写满后覆盖最旧的记录，线程退出后缓冲区留给之后新建的线程复用。
+ * 需要时导出为Chrome trace JSON，可以直接用Perfetto或chrome://tracing打开，
+ * 按线程查看每帧时间花在了哪里。
+ *
+ * 只有定义了QUOTECLIENT_TRACING（CMake选项QUOTECLIENT_TRACING）时TRACE_SCOPE才会展开，
+ * 否则不产生任何代码
+ */
+class Tracer
+{
+public:
+    static const int kBufferCapacity = 1 << 15;  // 每个线程保留的记录数
+
+    /**
+     * @brief 运行时开启或关闭记录（默认开启）
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief 是否正在记录
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief 当前单调时钟时间（纳秒）
+     */
+    static qint64 now();
+
+    /**
+     * @brief 记录一段耗时
+     * @param name 名称，必须是字符串字面量（只保存指针）
+     * @param start 开始时间（纳秒）
+     * @param end 结束时间（纳秒）
+     */
+    static void record(const char *name, qint64 start, qint64 end);
+
+    /**
+     * @brief 导出所有线程缓冲区中的记录
+     * @param path 文件路径
+     * @return 写入成功返回true
+     */
+    static bool exportChromeTrace(const QString& path);
+
+    /**
+     * @brief 清空所有线程的记录
+     */
+    static void clear();
+};
+
+/**
+ * @brief 作用域跟踪，构造时记下开始时间，析构时写入记录
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(name)
+        , m_start(Tracer::isEnabled() ? Tracer::now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_start != 0) {
+            Tracer::record(m_name, m_start, Tracer::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char *m_name;  // 名称
+    qint64 m_start;      // 开始时间，0表示未记录
+};
+
+#ifdef QUOTECLIENT_TRACING
+#define QUOTE_TRACE_CONCAT_IMPL(a, b) a##b
+#define QUOTE_TRACE_CONCAT(a, b) QUOTE_TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) TraceScope QUOTE_TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
\ No newline at end of file
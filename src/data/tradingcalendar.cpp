@@ -0,0 +1,177 @@
+#include "tradingcalendar.h"
+#include <QFile>
+#include <QTextStream>
+
+namespace {
+
+/**
+ * @brief 一个交易日内的阶段边界，按时间升序
+ */
+struct PhaseBoundary {
+    int second;                    // 从零点起的秒数
+    TradingCalendar::Phase phase;  // 从该时刻开始的阶段
+};
+
+const PhaseBoundary kBoundaries[] = {
+    { (9 * 60 + 15) * 60, TradingCalendar::OpeningAuctionPhase },
+    { (9 * 60 + 25) * 60, TradingCalendar::PreOpenPhase },
+    { TradingCalendar::kMorningOpen * 60, TradingCalendar::ContinuousPhase },
+    { TradingCalendar::kMorningClose * 60, TradingCalendar::LunchBreakPhase },
+    { TradingCalendar::kAfternoonOpen * 60, TradingCalendar::ContinuousPhase },
+    { (TradingCalendar::kAfternoonClose - 3) * 60, TradingCalendar::ClosingAuctionPhase },
+    { TradingCalendar::kAfternoonClose * 60, TradingCalendar::ClosedPhase },
+};
+
+// 节假日表最多覆盖一年，查找相邻交易日时最多走这么多天
+const int kMaxSearchDays = 366;
+
+/**
+ * @brief 零点起的秒数对应的时刻
+ */
+QTime secondTime(int second)
+{
+    return QTime(second / 3600, second / 60 % 60);
+}
+
+} // namespace
+
+TradingCalendar::TradingCalendar()
+{
+}
+
+TradingCalendar::~TradingCalendar()
+{
+}
+
+void TradingCalendar::setHolidays(const QSet<QDate>& holidays)
+{
+    m_holidays = holidays;
+}
+
+bool TradingCalendar::loadHolidays(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QSet<QDate> holidays;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QDate date = QDate::fromString(line, Qt::ISODate);
+        if (date.isValid()) {
+            holidays.insert(date);
+        }
+    }
+
+    m_holidays = holidays;
+    return true;
+}
+
+bool TradingCalendar::isTradingDay(const QDate& date) const
+{
+    return date.isValid() && date.dayOfWeek() <= 5 && !m_holidays.contains(date);
+}
+
+QDate TradingCalendar::previousTradingDay(const QDate& date) const
+{
+    QDate day = date.addDays(-1);
+    for (int i = 0; i < kMaxSearchDays && !isTradingDay(day); ++i) {
+        day = day.addDays(-1);
+    }
+    return day;
+}
+
+QDate TradingCalendar::nextTradingDay(const QDate& date) const
+{
+    QDate day = date.addDays(1);
+    for (int i = 0; i < kMaxSearchDays && !isTradingDay(day); ++i) {
+        day = day.addDays(1);
+    }
+    return day;
+}
+
+TradingCalendar::Phase TradingCalendar::phase(const QDateTime& time) const
+{
+    QDateTime exchangeTime = time.toTimeZone(timeZone());
+    if (!isTradingDay(exchangeTime.date())) {
+        return ClosedPhase;
+    }
+
+    int second = exchangeTime.time().msecsSinceStartOfDay() / 1000;
+    Phase result = ClosedPhase;
+    for (const PhaseBoundary& boundary : kBoundaries) {
+        if (second < boundary.second) {
+            break;
+        }
+        result = boundary.phase;
+    }
+    return result;
+}
+
+QDateTime TradingCalendar::nextPhaseChange(const QDateTime& time) const
+{
+    QTimeZone zone = timeZone();
+    QDateTime exchangeTime = time.toTimeZone(zone);
+
+    // 当天还有未到的边界
+    if (isTradingDay(exchangeTime.date())) {
+        int second = exchangeTime.time().msecsSinceStartOfDay() / 1000;
+        for (const PhaseBoundary& boundary : kBoundaries) {
+            if (second < boundary.second) {
+                return QDateTime(exchangeTime.date(), secondTime(boundary.second), zone);
+            }
+        }
+    }
+
+    // 下一个交易日的开盘集合竞价
+    return QDateTime(nextTradingDay(exchangeTime.date()), secondTime(kBoundaries[0].second), zone);
+}
+
+QTimeZone TradingCalendar::timeZone()
+{
+    // 系统没有时区数据库时退回固定的UTC+8，中国不实行夏令时，两者等价
+    static const QTimeZone zone = QTimeZone::isTimeZoneIdAvailable("Asia/Shanghai")
+                                      ? QTimeZone("Asia/Shanghai")
+                                      : QTimeZone(8 * 3600);
+    return zone;
+}
+
+QDateTime TradingCalendar::currentTime()
+{
+    return QDateTime::currentDateTime().toTimeZone(timeZone());
+}
+
+bool TradingCalendar::isActive(Phase phase)
+{
+    return phase == OpeningAuctionPhase || phase == ContinuousPhase || phase == ClosingAuctionPhase;
+}
+
+QString TradingCalendar::phaseName(Phase phase)
+{
+    switch (phase) {
+    case ClosedPhase:
+        return "休市";
+    case OpeningAuctionPhase:
+        return "开盘集合竞价";
+    case PreOpenPhase:
+        return "等待开盘";
+    case ContinuousPhase:
+        return "连续竞价";
+    case LunchBreakPhase:
+        return "午间休市";
+    case ClosingAuctionPhase:
+        return "收盘集合竞价";
+    }
+    return QString();
+}
+
+const TradingCalendar& TradingCalendar::weekdays()
+{
+    static const TradingCalendar calendar;
+    return calendar;
+}
\ No newline at end of file
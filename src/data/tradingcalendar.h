@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QDate>
+#include <QDateTime>
+#include <QSet>
+#include <QString>
+#include <QTimeZone>
+
+/**
+ * @brief A股交易日历
+ *
+ * 交易日为周一至周五中不在节假日表里的日期。一个交易日内的阶段：
+ * 9:15-9:25开盘集合竞价，9:25-9:30等待开盘，9:30-11:30和13:00-14:57连续竞价，
+ * 11:30-13:00午休，14:57-15:00收盘集合竞价，其余时间休市。
+ * 交易日和交易时段的唯一来源，分时坐标轴、历史分时和模拟行情都由此判断。
+ * 日期和时段都按交易所所在的上海时间计算，与本机时区无关
+ */
+class TradingCalendar
+{
+public:
+    // 交易时段（从零点起的分钟数）
+    static const int kMorningOpen = 9 * 60 + 30;     // 9:30
+    static const int kMorningClose = 11 * 60 + 30;   // 11:30
+    static const int kAfternoonOpen = 13 * 60;       // 13:00
+    static const int kAfternoonClose = 15 * 60;      // 15:00
+
+    /**
+     * @brief 交易阶段
+     */
+    enum Phase {
+        ClosedPhase,           // 休市（非交易日、开盘前和收盘后）
+        OpeningAuctionPhase,   // 开盘集合竞价
+        PreOpenPhase,          // 集合竞价结束，等待开盘
+        ContinuousPhase,       // 连续竞价
+        LunchBreakPhase,       // 午间休市
+        ClosingAuctionPhase    // 收盘集合竞价
+    };
+
+    TradingCalendar();
+    ~TradingCalendar();
+
+    /**
+     * @brief 设置节假日（休市的工作日）
+     * @param holidays 节假日
+     */
+    void setHolidays(const QSet<QDate>& holidays);
+
+    /**
+     * @brief 从文件加载节假日
+     *
+     * 每行一个yyyy-MM-dd格式的日期，空行和#开头的行被忽略
+     * @param path 文件路径
+     * @return 文件存在并读取成功返回true
+     */
+    bool loadHolidays(const QString& path);
+
+    /**
+     * @brief 节假日
+     */
+    const QSet<QDate>& holidays() const { return m_holidays; }
+
+    /**
+     * @brief 是否为交易日
+     * @param date 日期
+     */
+    bool isTradingDay(const QDate& date) const;
+
+    /**
+     * @brief 前一个交易日
+     * @param date 日期
+     * @return 严格早于date的最近一个交易日
+     */
+    QDate previousTradingDay(const QDate& date) const;
+
+    /**
+     * @brief 后一个交易日
+     * @param date 日期
+     * @return 严格晚于date的最近一个交易日
+     */
+    QDate nextTradingDay(const QDate& date) const;
+
+    /**
+     * @brief 指定时刻所处的交易阶段
+     * @param time 时刻（任意时区，转换为上海时间判断）
+     */
+    Phase phase(const QDateTime& time) const;
+
+    /**
+     * @brief 下一次阶段变化的时刻
+     * @param time 当前时刻（任意时区）
+     * @return 严格晚于time的最近一次阶段变化，上海时间
+     */
+    QDateTime nextPhaseChange(const QDateTime& time) const;
+
+    /**
+     * @brief 交易所时区（Asia/Shanghai）
+     */
+    static QTimeZone timeZone();
+
+    /**
+     * @brief 当前的上海时间
+     */
+    static QDateTime currentTime();
+
+    /**
+     * @brief 该阶段行情是否会变化（集合竞价和连续竞价）
+     */
+    static bool isActive(Phase phase);
+
+    /**
+     * @brief 阶段名称
+     */
+    static QString phaseName(Phase phase);
+
+    /**
+     * @brief 没有节假日的日历，未设置交易日历时使用
+     */
+    static const TradingCalendar& weekdays();
+
+private:
+    QSet<QDate> m_holidays;  // 节假日
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "app/headlessrunner.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    // 没有显示器时使用离屏平台
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("QuoteClientHeadless");
+    QApplication::setApplicationVersion("1.0.0");
+    QApplication::setOrganizationName("QuoteOrg");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面运行行情管线并报告吞吐量、延迟和内存");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption symbolsOption("symbols", "模拟的股票数量（默认1000）", "count", "1000");
+    QCommandLineOption durationOption("duration", "运行时长，秒（默认10）", "seconds", "10");
+    QCommandLineOption intervalOption("interval", "推送间隔，毫秒（默认0，尽快推送）", "msecs", "0");
+    QCommandLineOption feedOption("feed", "回放录制的行情文件，每行一个JSON行情包", "file");
+    QCommandLineOption renderOption("render", "每次推送后离屏绘制行情表格");
+    QCommandLineOption jsonOption("json", "以JSON格式输出结果");
+    parser.addOptions({symbolsOption, durationOption, intervalOption, feedOption, renderOption, jsonOption});
+    parser.process(app);
+
+    HeadlessRunner::Options options;
+    options.symbols = qMax(1, parser.value(symbolsOption).toInt());
+    options.durationMs = qMax(1, parser.value(durationOption).toInt()) * 1000;
+    options.intervalMs = qMax(0, parser.value(intervalOption).toInt());
+    options.feedFile = parser.value(feedOption);
+    options.render = parser.isSet(renderOption);
+
+    HeadlessRunner runner(options);
+    QObject::connect(&runner, &HeadlessRunner::finished, &app, &QApplication::quit);
+
+    if (!runner.start()) {
+        QTextStream(stderr) << "Cannot read feed file: " << options.feedFile << "\n";
+        return 1;
+    }
+
+    int result = app.exec();
+
+    QTextStream(stdout) << runner.report(parser.isSet(jsonOption));
+    return result;
+}
\ No newline at end of file
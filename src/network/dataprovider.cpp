@@ -1,14 +1,20 @@
 #include "dataprovider.h"
+#include "../data/sessionaxis.h"
+#include "../data/tracer.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
 #include <QRandomGenerator>
+#include <QTimer>
+#include <QUrlQuery>
+#include <QtMath>
 
 DataProvider::DataProvider(QObject *parent)
     : QObject(parent)
     , m_isRunning(false)
     , m_useSimulatedData(true)  // 默认使用模拟数据（实际项目中应连接真实数据源）
+    , m_tradingCalendar(&TradingCalendar::weekdays())
 {
     // 初始化模拟股票列表
     m_simulatedStocks = {
@@ -27,14 +33,6 @@ DataProvider::DataProvider(QObject *parent)
         {"688111", "金山办公"},
         {"688981", "中芯国际"}
     };
-
-    // 连接网络响应信号
-    connect(&m_networkManager, &QNetworkAccessManager::finished,
-            this, &DataProvider::onNetworkReply);
-    
-    // 连接模拟数据定时器
-    connect(&m_simulateTimer, &QTimer::timeout,
-            this, &DataProvider::onSimulateDataTimer);
 }
 
 DataProvider::~DataProvider()
@@ -48,12 +46,9 @@ void DataProvider::start()
         m_isRunning = true;
         
         if (m_useSimulatedData) {
-            // 使用模拟数据，立即生成一次数据并启动定时器
+            // 使用模拟数据，立即生成一次数据
             MarketData data = generateSimulatedData();
             emit dataReceived(data);
-            
-            // 启动模拟数据定时器（每3秒更新一次）
-            m_simulateTimer.start(3000);
         } else {
             // 从真实数据源获取数据
             // TODO: 替换为实际的数据源URL
@@ -64,14 +59,200 @@ void DataProvider::start()
 
 void DataProvider::stop()
 {
-    if (m_isRunning) {
-        m_isRunning = false;
+    m_isRunning = false;
+}
+
+void DataProvider::setSimulatedStocks(const QMap<QString, QString>& stocks)
+{
+    m_simulatedStocks = stocks;
+    
+    // 股票列表变化后下次重新生成完整数据
+    m_simulatedData.clear();
+}
+
+void DataProvider::setTradingCalendar(const TradingCalendar *calendar)
+{
+    m_tradingCalendar = calendar ? calendar : &TradingCalendar::weekdays();
+    
+    // 交易日变化后下次重新生成完整数据
+    m_simulatedData.clear();
+}
+
+void DataProvider::requestKLineHistory(const QString& code, qint64 barInterval, qint64 endTime, int count)
+{
+    if (m_useSimulatedData) {
+        // 模拟数据在下一轮事件循环中送回，与网络请求一样异步完成
+        QTimer::singleShot(0, this, [this, code, barInterval, endTime, count]() {
+            emit kLineHistoryLoaded(code, barInterval, endTime,
+                                    simulateKLineHistory(code, barInterval, endTime, count), true);
+        });
+        return;
+    }
+    
+    QUrlQuery query;
+    query.addQueryItem("code", code);
+    query.addQueryItem("interval", QString::number(barInterval));
+    query.addQueryItem("end", QString::number(endTime));
+    query.addQueryItem("count", QString::number(count));
+    
+    QUrl url("https://api.example.com/market/kline");
+    url.setQuery(query);
+    
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    
+    QNetworkReply *reply = m_networkManager.get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, code, barInterval, endTime]() {
+        bool ok = reply->error() == QNetworkReply::NoError;
+        if (!ok) {
+            qDebug() << "K-line history error:" << reply->errorString();
+        }
         
-        // 停止模拟数据定时器
-        if (m_simulateTimer.isActive()) {
-            m_simulateTimer.stop();
+        OhlcvSeries series = ok ? parseKLineHistory(reply->readAll()) : OhlcvSeries();
+        emit kLineHistoryLoaded(code, barInterval, endTime, series, ok);
+        reply->deleteLater();
+    });
+}
+
+OhlcvSeries DataProvider::parseKLineHistory(const QByteArray& data)
+{
+    OhlcvSeries series;
+    
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        return series;
+    }
+    
+    const QJsonArray bars = doc.object().value("bars").toArray();
+    series.reserve(bars.size());
+    for (const QJsonValue& value : bars) {
+        const QJsonObject bar = value.toObject();
+        series.append(bar.value("time").toVariant().toLongLong(),
+                      bar.value("open").toDouble(),
+                      bar.value("high").toDouble(),
+                      bar.value("low").toDouble(),
+                      bar.value("close").toDouble(),
+                      bar.value("volume").toDouble());
+    }
+    
+    return series;
+}
+
+OhlcvSeries DataProvider::simulateKLineHistory(const QString& code, qint64 barInterval, qint64 endTime, int count) const
+{
+    OhlcvSeries series;
+    
+    // 模拟数据最多提供2600根历史K线（日K约十年）
+    const qint64 earliest = QDateTime::currentMSecsSinceEpoch() - barInterval * 2600;
+    qint64 firstTime = qMax(endTime - barInterval * count, earliest);
+    if (firstTime >= endTime) {
+        return series;
+    }
+    
+    // 价格由时间决定，相邻块可以无缝拼接；同一块的随机波动也固定
+    QRandomGenerator rng(quint32(qHash(code) ^ quint32(endTime / barInterval)));
+    double basePrice = 10.0 + qHash(code) % 90;
+    
+    series.reserve(int((endTime - firstTime) / barInterval));
+    for (qint64 time = firstTime; time + barInterval <= endTime; time += barInterval) {
+        double phase = double(time / barInterval);
+        double close = basePrice * (1.0 + 0.25 * qSin(phase / 64.0) + 0.08 * qSin(phase / 9.0));
+        double open = close * (1.0 + rng.bounded(-0.02, 0.02));
+        double high = qMax(open, close) * (1.0 + rng.bounded(0.0, 0.02));
+        double low = qMin(open, close) * (1.0 - rng.bounded(0.0, 0.02));
+        double volume = double(rng.bounded(500000LL, 5000000LL));
+        
+        series.append(time, open, high, low, close, volume);
+    }
+    
+    return series;
+}
+
+void DataProvider::requestIntradayHistory(const QString& code, const QDate& date)
+{
+    if (m_useSimulatedData) {
+        // 模拟数据在下一轮事件循环中送回，与网络请求一样异步完成
+        QTimer::singleShot(0, this, [this, code, date]() {
+            emit intradayHistoryLoaded(code, date, simulateIntradayHistory(code, date), true);
+        });
+        return;
+    }
+    
+    QUrlQuery query;
+    query.addQueryItem("code", code);
+    query.addQueryItem("date", date.toString(Qt::ISODate));
+    
+    QUrl url("https://api.example.com/market/intraday");
+    url.setQuery(query);
+    
+    QNetworkRequest request(url);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    
+    QNetworkReply *reply = m_networkManager.get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply, code, date]() {
+        bool ok = reply->error() == QNetworkReply::NoError;
+        if (!ok) {
+            qDebug() << "Intraday history error:" << reply->errorString();
         }
+        
+        QVector<TimeSeriesPoint> points = ok ? parseIntradayHistory(reply->readAll()) : QVector<TimeSeriesPoint>();
+        emit intradayHistoryLoaded(code, date, points, ok);
+        reply->deleteLater();
+    });
+}
+
+QVector<TimeSeriesPoint> DataProvider::parseIntradayHistory(const QByteArray& data)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        return QVector<TimeSeriesPoint>();
+    }
+    
+    // 经StockItem追加，均价与实时分时的计算方式一致
+    StockItem item;
+    const QJsonArray points = doc.object().value("points").toArray();
+    for (const QJsonValue& value : points) {
+        const QJsonObject object = value.toObject();
+        
+        TimeSeriesPoint point;
+        point.timestamp = QDateTime::fromMSecsSinceEpoch(object.value("time").toVariant().toLongLong(),
+                                                         TradingCalendar::timeZone());
+        point.price = object.value("price").toDouble();
+        point.volume = object.value("volume").toVariant().toLongLong();
+        
+        item.addTimeSeriesPoint(point);
     }
+    
+    return item.getTimeSeriesData();
+}
+
+QVector<TimeSeriesPoint> DataProvider::simulateIntradayHistory(const QString& code, const QDate& date) const
+{
+    // 模拟数据只提供最近30天内的往日交易日
+    QDate today = TradingCalendar::currentTime().date();
+    if (date >= today || date < today.addDays(-30) || !m_tradingCalendar->isTradingDay(date)) {
+        return QVector<TimeSeriesPoint>();
+    }
+    
+    // 价格由日期决定，同一天的数据每次加载都相同
+    QRandomGenerator rng(quint32(qHash(code) ^ quint32(date.toJulianDay())));
+    double basePrice = 10.0 + qHash(code) % 90;
+    double lastPrice = basePrice * (1.0 + 0.08 * qSin(date.toJulianDay() / 9.0));
+    
+    // 经StockItem追加，均价与实时分时的计算方式一致
+    StockItem item;
+    QDateTime startOfDay = date.startOfDay(TradingCalendar::timeZone());
+    for (int minute = 0; minute < SessionAxis::kMinutesPerDay; ++minute) {
+        TimeSeriesPoint point;
+        point.timestamp = startOfDay.addSecs(QTime(0, 0).secsTo(SessionAxis::minuteTime(minute)));
+        point.price = lastPrice * (1.0 + rng.bounded(-0.005, 0.005));
+        point.volume = rng.bounded(10000LL, 100000LL);
+        
+        item.addTimeSeriesPoint(point);
+        lastPrice = point.price;
+    }
+    
+    return item.getTimeSeriesData();
 }
 
 void DataProvider::onRefreshRequested()
@@ -90,12 +271,22 @@ void DataProvider::onRefreshRequested()
 
 void DataProvider::onNetworkReply(QNetworkReply* reply)
 {
+    TRACE_SCOPE("DataProvider::onNetworkReply");
     if (reply->error() == QNetworkReply::NoError) {
         // 读取数据
+        TickStamps stamps;
+        stamps.received = TickStamps::now();
         QByteArray data = reply->readAll();
         
-        // 解析数据
-        MarketData marketData = parseMarketData(data);
+        // 解析数据，格式错误时丢弃本次回复，不当作新的行情发出
+        MarketData marketData;
+        if (!parseMarketData(data, &marketData)) {
+            qDebug() << "Invalid market data:" << data.left(64);
+            reply->deleteLater();
+            return;
+        }
+        stamps.decoded = TickStamps::now();
+        marketData.setTickStamps(stamps);
         
         // 发送数据接收信号
         emit dataReceived(marketData);
@@ -106,235 +297,299 @@ void DataProvider::onNetworkReply(QNetworkReply* reply)
     reply->deleteLater();
 }
 
-void DataProvider::onSimulateDataTimer()
-{
-    if (m_isRunning && m_useSimulatedData) {
-        // 生成模拟数据
-        MarketData data = generateSimulatedData();
-        
-        // 发送数据接收信号
-        emit dataReceived(data);
-    }
-}
-
 void DataProvider::fetchDataFromNetwork(const QUrl& url)
 {
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
     // 发送GET请求
-    m_networkManager.get(request);
+    QNetworkReply *reply = m_networkManager.get(request);
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        onNetworkReply(reply);
+    });
 }
 
-MarketData DataProvider::parseMarketData(const QByteArray& data)
+bool DataProvider::parseMarketData(const QByteArray& data, MarketData *marketData)
 {
-    MarketData marketData;
+    TRACE_SCOPE("DataProvider::parseMarketData");
     
     // 解析JSON数据
     QJsonDocument doc = QJsonDocument::fromJson(data);
+    if (doc.isNull() || !doc.isObject()) {
+        return false;
+    }
     
-    if (!doc.isNull() && doc.isObject()) {
-        QJsonObject root = doc.object();
-        
-        // 解析股票数据
-        if (root.contains("stocks") && root["stocks"].isArray()) {
-            QJsonArray stocks = root["stocks"].toArray();
-            
-            for (const QJsonValue& value : stocks) {
-                if (value.isObject()) {
-                    QJsonObject stock = value.toObject();
-                    
-                    // 创建股票对象
-                    StockItem item;
-                    
-                    // 解析基本信息
-                    if (stock.contains("code")) {
-                        item.setCode(stock["code"].toString());
-                    }
-                    
-                    if (stock.contains("name")) {
-                        item.setName(stock["name"].toString());
-                    }
-                    
-                    // 解析价格信息
-                    if (stock.contains("current")) {
-                        item.setCurrentPrice(stock["current"].toDouble());
-                    }
-                    
-                    if (stock.contains("open")) {
-                        item.setOpenPrice(stock["open"].toDouble());
-                    }
-                    
-                    if (stock.contains("high")) {
-                        item.setHighPrice(stock["high"].toDouble());
-                    }
-                    
-                    if (stock.contains("low")) {
-                        item.setLowPrice(stock["low"].toDouble());
-                    }
-                    
-                    if (stock.contains("previous")) {
-                        item.setPreviousClose(stock["previous"].toDouble());
-                    }
-                    
-                    // 解析成交信息
-                    if (stock.contains("volume")) {
-                        item.setVolume(stock["volume"].toVariant().toLongLong());
-                    }
-                    
-                    if (stock.contains("amount")) {
-                        item.setAmount(stock["amount"].toDouble());
-                    }
-                    
-                    // 设置更新时间
-                    item.setUpdateTime(QDateTime::currentDateTime());
-                    
-                    // 添加到市场数据
-                    marketData.addOrUpdateStock(item);
-                }
-            }
-        }
-        
-        // 设置更新时间
-        marketData.setUpdateTime(QDateTime::currentDateTime());
+    // 只读访问，避免JSON对象被复制
+    const QJsonObject root = doc.object();
+    const QJsonValue stocksValue = root.value("stocks");
+    if (!stocksValue.isArray()) {
+        return false;
     }
     
-    return marketData;
-}
-
-MarketData DataProvider::generateSimulatedData()
-{
-    MarketData marketData;
-    QRandomGenerator *rng = QRandomGenerator::global();
+    m_parsedData.setTickStamps(TickStamps());
     
-    // 当前时间
-    QDateTime now = QDateTime::currentDateTime();
+    // 本批行情使用同一个更新时间（上海时间）
+    QDateTime now = TradingCalendar::currentTime();
     
-    // 生成模拟股票数据
-    for (auto it = m_simulatedStocks.constBegin(); it != m_simulatedStocks.constEnd(); ++it) {
-        QString code = it.key();
-        QString name = it.value();
-        
-        // 创建股票对象
-        StockItem item(code, name);
+    // 先把所有股票记为缺席一次，本次出现的股票再清零
+    for (auto it = m_missedPackets.begin(); it != m_missedPackets.end(); ++it) {
+        ++it.value();
+    }
+    
+    // 解析股票数据
+    const QJsonArray stocks = stocksValue.toArray();
+    
+    for (const QJsonValue& value : stocks) {
+        if (!value.isObject()) {
+            continue;
+        }
         
-        // 设置模拟价格（随机生成）
-        double basePrice = 0.0;
+        const QJsonObject stock = value.toObject();
+        QString code = stock.value("code").toString();
+        if (code.isEmpty()) {
+            continue;
+        }
         
-        // 根据股票代码设置基础价格区间
-        if (code.startsWith("600") || code.startsWith("601")) {
-            basePrice = rng->bounded(10.0, 50.0);
-        } else if (code.startsWith("000")) {
-            basePrice = rng->bounded(8.0, 40.0);
-        } else if (code.startsWith("300")) {
-            basePrice = rng->bounded(30.0, 80.0);
-        } else if (code.startsWith("688")) {
-            basePrice = rng->bounded(50.0, 150.0);
+        // 在上一次的股票对象上原地更新，新股票才创建对象并设置名称
+        StockItem *item = m_parsedData.findStock(code);
+        if (!item) {
+            m_parsedData.addOrUpdateStock(StockItem(code, stock.value("name").toString()));
+            item = m_parsedData.findStock(code);
         }
+        m_missedPackets[code] = 0;
         
-        // 昨收价
-        double previousClose = basePrice * (1.0 + rng->bounded(-0.02, 0.02));
-        item.setPreviousClose(previousClose);
+        // 解析价格信息
+        if (stock.contains("current")) {
+            item->setCurrentPrice(stock.value("current").toDouble());
+        }
         
-        // 当前价（在昨收价基础上波动）
-        double currentPrice = previousClose * (1.0 + rng->bounded(-0.1, 0.1));
-        item.setCurrentPrice(currentPrice);
+        if (stock.contains("open")) {
+            item->setOpenPrice(stock.value("open").toDouble());
+        }
         
-        // 开盘价
-        double openPrice = previousClose * (1.0 + rng->bounded(-0.03, 0.03));
-        item.setOpenPrice(openPrice);
+        if (stock.contains("high")) {
+            item->setHighPrice(stock.value("high").toDouble());
+        }
         
-        // 确保最高价和最低价合理
-        double highPrice = qMax(currentPrice, openPrice) * (1.0 + rng->bounded(0.0, 0.05));
-        double lowPrice = qMin(currentPrice, openPrice) * (1.0 - rng->bounded(0.0, 0.05));
+        if (stock.contains("low")) {
+            item->setLowPrice(stock.value("low").toDouble());
+        }
         
-        item.setHighPrice(highPrice);
-        item.setLowPrice(lowPrice);
+        if (stock.contains("previous")) {
+            item->setPreviousClose(stock.value("previous").toDouble());
+        }
         
-        // 成交量和金额
-        long long volume = rng->bounded(100000LL, 10000000LL);
-        double amount = volume * currentPrice;
+        // 解析成交信息
+        if (stock.contains("volume")) {
+            item->setVolume(stock.value("volume").toVariant().toLongLong());
+        }
         
-        item.setVolume(volume);
-        item.setAmount(amount);
+        if (stock.contains("amount")) {
+            item->setAmount(stock.value("amount").toDouble());
+        }
         
         // 设置更新时间
-        item.setUpdateTime(now);
-        
-        // 生成K线数据（假设过去30个交易日的数据）
-        QVector<StockTradeData> kLineData;
-        
-        // 从30天前开始
-        QDateTime startDate = now.addDays(-30);
-        double lastClose = previousClose * 0.9;  // 初始价格
-        
-        for (int i = 0; i < 30; i++) {
-            StockTradeData data;
-            data.timestamp = startDate.addDays(i);
-            
-            // 基于前一天收盘价随机生成今天的价格
-            double dailyChange = rng->bounded(-0.05, 0.05);
-            data.open = lastClose * (1.0 + rng->bounded(-0.01, 0.01));
-            data.close = lastClose * (1.0 + dailyChange);
-            data.high = qMax(data.open, data.close) * (1.0 + rng->bounded(0.0, 0.03));
-            data.low = qMin(data.open, data.close) * (1.0 - rng->bounded(0.0, 0.03));
-            data.volume = rng->bounded(500000LL, 5000000LL);
-            data.amount = data.volume * (data.high + data.low) / 2;
-            
-            kLineData.append(data);
-            lastClose = data.close;
+        item->setUpdateTime(now);
+    }
+    
+    // 连续多次没有出现的股票视为已下线（如退市或换码），不再保留旧行情
+    for (auto it = m_missedPackets.begin(); it != m_missedPackets.end();) {
+        if (it.value() >= kMaxMissedPackets) {
+            m_parsedData.removeStock(it.key());
+            it = m_missedPackets.erase(it);
+        } else {
+            ++it;
         }
-        
-        item.setKLineData(kLineData);
-        
-        // 生成分时数据（假设今天的数据）
-        QVector<TimeSeriesPoint> timeSeriesData;
-        
-        // 交易时间9:30-11:30, 13:00-15:00
-        QTime startTime1(9, 30);
-        QTime endTime1(11, 30);
-        QTime startTime2(13, 0);
-        QTime endTime2(15, 0);
-        
-        QDateTime today = now.date().startOfDay();
-        double lastPrice = openPrice;
-        
-        // 上午交易时段
-        for (int minute = 0; minute < 120; minute++) {
-            QTime time = startTime1.addSecs(minute * 60);
-            QDateTime timestamp = today.addSecs(time.hour() * 3600 + time.minute() * 60);
-            
-            TimeSeriesPoint point;
-            point.timestamp = timestamp;
-            point.price = lastPrice * (1.0 + rng->bounded(-0.005, 0.005));
-            point.volume = rng->bounded(10000LL, 100000LL);
-            
-            timeSeriesData.append(point);
-            lastPrice = point.price;
+    }
+    
+    // 设置更新时间
+    m_parsedData.setUpdateTime(now);
+    *marketData = m_parsedData;
+    return true;
+}
+
+MarketData DataProvider::generateSimulatedData()
+{
+    TRACE_SCOPE("DataProvider::generateSimulatedData");
+    // 模拟数据以开始生成的时刻作为收到时间
+    TickStamps stamps;
+    stamps.received = TickStamps::now();
+    
+    // 当前时间，按上海时间换日和生成分时
+    QDateTime now = TradingCalendar::currentTime();
+    
+    if (m_simulatedData.getAllStocks().isEmpty() || m_simulatedDate != now.date()) {
+        // 首次生成或换日：生成每只股票当天的完整数据
+        m_simulatedData.clear();
+        for (auto it = m_simulatedStocks.constBegin(); it != m_simulatedStocks.constEnd(); ++it) {
+            m_simulatedData.addOrUpdateStock(createSimulatedStock(it.key(), it.value(), now));
         }
+        m_simulatedDate = now.date();
+    } else {
+        // 在上一次的行情上推进，K线和已收盘的分时点保持不变
+        m_simulatedData.updateAllStocks([this, &now](StockItem& item) {
+            advanceSimulatedStock(item, now);
+        });
+    }
+    
+    // 设置更新时间
+    m_simulatedData.setUpdateTime(now);
+    
+    stamps.decoded = TickStamps::now();
+    m_simulatedData.setTickStamps(stamps);
+    
+    return m_simulatedData;
+}
+
+StockItem DataProvider::createSimulatedStock(const QString& code, const QString& name, const QDateTime& now) const
+{
+    QRandomGenerator *rng = QRandomGenerator::global();
+    
+    // 创建股票对象
+    StockItem item(code, name);
+    
+    // 设置模拟价格（随机生成）
+    double basePrice = 0.0;
+    
+    // 根据板块设置基础价格区间
+    switch (item.getMarketType()) {
+    case StockItem::MarketType::ShanghaiA:
+        basePrice = rng->bounded(10.0, 50.0);
+        break;
+    case StockItem::MarketType::ShenzhenA:
+        basePrice = rng->bounded(8.0, 40.0);
+        break;
+    case StockItem::MarketType::ChiNext:
+        basePrice = rng->bounded(30.0, 80.0);
+        break;
+    case StockItem::MarketType::StarMarket:
+        basePrice = rng->bounded(50.0, 150.0);
+        break;
+    case StockItem::MarketType::Unknown:
+        break;
+    }
+    
+    // 昨收价
+    double previousClose = basePrice * (1.0 + rng->bounded(-0.02, 0.02));
+    item.setPreviousClose(previousClose);
+    
+    // 当前价（在昨收价基础上波动）
+    double currentPrice = previousClose * (1.0 + rng->bounded(-0.1, 0.1));
+    item.setCurrentPrice(currentPrice);
+    
+    // 开盘价
+    double openPrice = previousClose * (1.0 + rng->bounded(-0.03, 0.03));
+    item.setOpenPrice(openPrice);
+    
+    // 确保最高价和最低价合理
+    double highPrice = qMax(currentPrice, openPrice) * (1.0 + rng->bounded(0.0, 0.05));
+    double lowPrice = qMin(currentPrice, openPrice) * (1.0 - rng->bounded(0.0, 0.05));
+    
+    item.setHighPrice(highPrice);
+    item.setLowPrice(lowPrice);
+    
+    // 成交量和金额
+    long long volume = rng->bounded(100000LL, 10000000LL);
+    double amount = volume * currentPrice;
+    
+    item.setVolume(volume);
+    item.setAmount(amount);
+    
+    // 设置更新时间
+    item.setUpdateTime(now);
+    
+    // 生成K线数据（假设过去30个交易日的数据）
+    QVector<StockTradeData> kLineData;
+    kLineData.reserve(30);
+    
+    // 从30天前开始，日K线对齐到零点，保证同一根K线的时间戳在各次刷新之间不变
+    QDateTime startDate = now.date().addDays(-30).startOfDay(TradingCalendar::timeZone());
+    double lastClose = previousClose * 0.9;  // 初始价格
+    
+    for (int i = 0; i < 30; i++) {
+        StockTradeData data;
+        data.timestamp = startDate.addDays(i);
         
-        // 下午交易时段
-        for (int minute = 0; minute < 120; minute++) {
-            QTime time = startTime2.addSecs(minute * 60);
-            QDateTime timestamp = today.addSecs(time.hour() * 3600 + time.minute() * 60);
-            
-            TimeSeriesPoint point;
-            point.timestamp = timestamp;
-            point.price = lastPrice * (1.0 + rng->bounded(-0.005, 0.005));
-            point.volume = rng->bounded(10000LL, 100000LL);
-            
-            timeSeriesData.append(point);
-            lastPrice = point.price;
-        }
+        // 基于前一天收盘价随机生成今天的价格
+        double dailyChange = rng->bounded(-0.05, 0.05);
+        data.open = lastClose * (1.0 + rng->bounded(-0.01, 0.01));
+        data.close = lastClose * (1.0 + dailyChange);
+        data.high = qMax(data.open, data.close) * (1.0 + rng->bounded(0.0, 0.03));
+        data.low = qMin(data.open, data.close) * (1.0 - rng->bounded(0.0, 0.03));
+        data.volume = rng->bounded(500000LL, 5000000LL);
+        data.amount = data.volume * (data.high + data.low) / 2;
         
-        item.setTimeSeriesData(timeSeriesData);
+        kLineData.append(data);
+        lastClose = data.close;
+    }
+    
+    item.setKLineData(kLineData);
+    
+    // 生成今天的分时数据：交易日的交易时段内只生成到当前分钟，之后随行情逐分钟追加；
+    // 开盘前没有分时数据，午休、收盘后和非交易日生成已经过去的整段
+    int minutes = SessionAxis::kMinutesPerDay;
+    if (m_tradingCalendar->isTradingDay(now.date())) {
+        QTime time = now.time();
+        int minuteOfDay = time.hour() * 60 + time.minute();
+        int minute = SessionAxis::sessionMinute(time);
+        if (minute >= 0) {
+            minutes = minute + 1;
+        } else if (minuteOfDay < TradingCalendar::kMorningOpen) {
+            minutes = 0;
+        } else if (minuteOfDay < TradingCalendar::kAfternoonOpen) {
+            minutes = SessionAxis::kMinutesPerDay / 2;
+        }
+    }
+    
+    QDateTime today = now.date().startOfDay(TradingCalendar::timeZone());
+    double lastPrice = openPrice;
+    
+    for (int minute = 0; minute < minutes; minute++) {
+        TimeSeriesPoint point;
+        point.timestamp = today.addSecs(QTime(0, 0).secsTo(SessionAxis::minuteTime(minute)));
+        point.price = lastPrice * (1.0 + rng->bounded(-0.005, 0.005));
+        point.volume = rng->bounded(10000LL, 100000LL);
         
-        // 添加到市场数据
-        marketData.addOrUpdateStock(item);
+        item.addTimeSeriesPoint(point);
+        lastPrice = point.price;
     }
     
-    // 设置更新时间
-    marketData.setUpdateTime(now);
+    return item;
+}
+
+void DataProvider::advanceSimulatedStock(StockItem& item, const QDateTime& now) const
+{
+    QRandomGenerator *rng = QRandomGenerator::global();
+    
+    // 在上一次的价格上随机游走，不超过涨跌停价
+    double price = item.getCurrentPrice() * (1.0 + rng->bounded(-0.005, 0.005));
+    price = qBound(item.getLimitDownPrice(), price, item.getLimitUpPrice());
+    long long volume = rng->bounded(1000LL, 50000LL);
+    
+    item.setCurrentPrice(price);
+    item.setHighPrice(qMax(item.getHighPrice(), price));
+    item.setLowPrice(qMin(item.getLowPrice(), price));
+    item.setVolume(item.getVolume() + volume);
+    item.setAmount(item.getAmount() + volume * price);
+    item.setUpdateTime(now);
     
-    return marketData;
+    // 交易时段内补齐到当前分钟，本次成交计入当前分钟
+    if (!m_tradingCalendar->isTradingDay(now.date())) {
+        return;
+    }
+    int minute = SessionAxis::sessionMinute(now.time());
+    if (minute < 0) {
+        return;
+    }
+    
+    QDateTime today = now.date().startOfDay(TradingCalendar::timeZone());
+    while (item.getTimeSeriesCount() <= minute) {
+        TimeSeriesPoint point;
+        point.timestamp = today.addSecs(QTime(0, 0).secsTo(SessionAxis::minuteTime(item.getTimeSeriesCount())));
+        point.price = price;
+        point.volume = 0;
+        
+        item.addTimeSeriesPoint(point);
+    }
+    item.updateLastTimeSeriesPoint(price, volume);
 } 
\ No newline at end of file
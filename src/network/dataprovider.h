@@ -1,12 +1,14 @@
 #pragma once
 
 #include "../data/marketdata.h"
+#include "../data/ohlcvseries.h"
+#include "../data/tradingcalendar.h"
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QUrl>
-#include <QTimer>
 #include <QMap>
+#include <QHash>
 
 /**
  * @brief 数据提供者类
@@ -18,11 +20,15 @@ class DataProvider : public QObject
     Q_OBJECT
 
 public:
+    static const int kMaxMissedPackets = 3;  // 股票连续多少次推送缺席后移除
+
     explicit DataProvider(QObject *parent = nullptr);
     ~DataProvider();
 
     /**
      * @brief 启动数据提供者
+     *
+     * 立即获取一次行情，之后由数据管理器按交易阶段发出刷新请求
      */
     void start();
 
@@ -31,6 +37,59 @@ public:
      */
     void stop();
 
+    /**
+     * @brief 异步加载历史K线，完成后发出kLineHistoryLoaded信号
+     * @param code 股票代码
+     * @param barInterval K线周期（毫秒）
+     * @param endTime 结束时间（毫秒，不含）
+     * @param count 最多加载的K线数量
+     */
+    void requestKLineHistory(const QString& code, qint64 barInterval, qint64 endTime, int count);
+
+    /**
+     * @brief 异步加载往日分时数据，完成后发出intradayHistoryLoaded信号
+     * @param code 股票代码
+     * @param date 交易日（早于今天）
+     */
+    void requestIntradayHistory(const QString& code, const QDate& date);
+
+    /**
+     * @brief 设置模拟数据的股票列表
+     * @param stocks 股票代码到名称的映射
+     */
+    void setSimulatedStocks(const QMap<QString, QString>& stocks);
+
+    /**
+     * @brief 模拟数据的股票列表
+     */
+    const QMap<QString, QString>& simulatedStocks() const { return m_simulatedStocks; }
+
+    /**
+     * @brief 设置模拟数据使用的交易日历
+     * @param calendar 交易日历，为空时只跳过周末
+     */
+    void setTradingCalendar(const TradingCalendar *calendar);
+
+    /**
+     * @brief 解析行情数据
+     *
+     * 在上一次解析结果上原地更新，推送中暂时没有出现的股票保留上一次的行情，
+     * 连续kMaxMissedPackets次缺席后移除；解析失败时不改动上一次的结果
+     * @param data 原始数据
+     * @param marketData 输出解析后的市场数据
+     * @return 数据格式正确时返回true
+     */
+    bool parseMarketData(const QByteArray& data, MarketData *marketData);
+
+    /**
+     * @brief 生成模拟数据（开发测试用）
+     *
+     * 首次调用或换日时生成每只股票当天的完整数据，之后只在上一次的价格上随机游走，
+     * 并更新当前分钟的分时点，不再每次重建K线和分时数据
+     * @return 模拟的市场数据
+     */
+    MarketData generateSimulatedData();
+
 signals:
     /**
      * @brief 数据接收完成信号
@@ -38,6 +97,27 @@ signals:
      */
     void dataReceived(const MarketData& data);
 
+    /**
+     * @brief 历史K线加载完成信号
+     * @param code 股票代码
+     * @param barInterval K线周期（毫秒）
+     * @param endTime 结束时间（毫秒，不含）
+     * @param series 按时间升序的历史K线，没有更早的数据时为空
+     * @param ok 是否加载成功
+     */
+    void kLineHistoryLoaded(const QString& code, qint64 barInterval, qint64 endTime,
+                            const OhlcvSeries& series, bool ok);
+
+    /**
+     * @brief 往日分时加载完成信号
+     * @param code 股票代码
+     * @param date 交易日
+     * @param points 该日的分时数据（含均价），非交易日或没有数据时为空
+     * @param ok 是否加载成功
+     */
+    void intradayHistoryLoaded(const QString& code, const QDate& date,
+                               const QVector<TimeSeriesPoint>& points, bool ok);
+
 public slots:
     /**
      * @brief 处理刷新请求
@@ -51,11 +131,6 @@ private slots:
      */
     void onNetworkReply(QNetworkReply* reply);
 
-    /**
-     * @brief 处理模拟数据生成定时器
-     */
-    void onSimulateDataTimer();
-
 private:
     /**
      * @brief 从网络获取数据
@@ -64,24 +139,56 @@ private:
     void fetchDataFromNetwork(const QUrl& url);
 
     /**
-     * @brief 解析行情数据
-     * @param data 原始数据
-     * @return 解析后的市场数据
+     * @brief 生成模拟的历史K线
+     *
+     * 价格由时间决定，相邻块可以无缝拼接，同一块每次生成的结果相同
      */
-    MarketData parseMarketData(const QByteArray& data);
+    OhlcvSeries simulateKLineHistory(const QString& code, qint64 barInterval, qint64 endTime, int count) const;
 
     /**
-     * @brief 生成模拟数据（开发测试用）
-     * @return 模拟的市场数据
+     * @brief 解析历史K线
+     * @param data 原始数据，格式为{"bars": [{"time", "open", "high", "low", "close", "volume"}]}，time为毫秒
      */
-    MarketData generateSimulatedData();
+    static OhlcvSeries parseKLineHistory(const QByteArray& data);
+
+    /**
+     * @brief 生成模拟的往日分时数据，只提供最近30天内的往日交易日
+     */
+    QVector<TimeSeriesPoint> simulateIntradayHistory(const QString& code, const QDate& date) const;
+
+    /**
+     * @brief 解析往日分时数据，均价按与实时分时相同的方式计算
+     * @param data 原始数据，格式为{"points": [{"time", "price", "volume"}]}，time为毫秒
+     */
+    static QVector<TimeSeriesPoint> parseIntradayHistory(const QByteArray& data);
+
+    /**
+     * @brief 生成一只股票当天的完整模拟数据
+     * @param code 股票代码
+     * @param name 股票名称
+     * @param now 当前时间
+     */
+    StockItem createSimulatedStock(const QString& code, const QString& name, const QDateTime& now) const;
+
+    /**
+     * @brief 在上一次的模拟数据上推进一次行情
+     * @param item 股票对象
+     * @param now 当前时间
+     */
+    void advanceSimulatedStock(StockItem& item, const QDateTime& now) const;
 
 private:
     QNetworkAccessManager m_networkManager;  // 网络管理器
-    QTimer m_simulateTimer;                  // 模拟数据定时器
     bool m_isRunning;                        // 运行状态标志
     bool m_useSimulatedData;                 // 是否使用模拟数据
 
     // 预设股票列表（用于模拟数据）
     QMap<QString, QString> m_simulatedStocks;
+    const TradingCalendar *m_tradingCalendar;  // 模拟数据的交易日历
+
+    // 跨次复用的行情状态，每次只原地更新变化的字段
+    MarketData m_simulatedData;              // 模拟行情
+    QDate m_simulatedDate;                   // 模拟行情所属的日期
+    MarketData m_parsedData;                 // 网络行情解析结果
+    QHash<QString, int> m_missedPackets;     // 股票连续缺席的推送次数
 }; 
\ No newline at end of file
@@ -0,0 +1,524 @@
+#include "candlestickrenderer.h"
+#include "../data/tradingcalendar.h"
+#include <QPainter>
+#include <QDateTime>
+#include <QFontMetrics>
+#include <QtMath>
+
+namespace {
+
+const QColor kUpColor(255, 0, 0);       // 红色表示上涨
+const QColor kDownColor(0, 128, 0);     // 绿色表示下跌
+const QColor kGridColor(220, 220, 220);
+
+// 均线颜色，按周期顺序循环使用
+const QColor kMovingAverageColors[] = {
+    QColor(255, 140, 0),     // 橙色
+    QColor(0, 112, 192),     // 蓝色
+    QColor(160, 32, 240)     // 紫色
+};
+
+const int kLeftMargin = 60;      // 价格标签宽度
+const int kRightMargin = 10;
+const int kTopMargin = 24;       // 标题高度
+const int kBottomMargin = 20;    // 时间标签高度
+const int kAreaSpacing = 6;      // 价格区与成交量区间距
+const int kInfoPadding = 3;      // 十字光标信息栏内边距
+
+const QColor kCrosshairColor(96, 96, 96);
+const QColor kCrosshairLabelColor(64, 64, 64);
+
+/**
+ * @brief 可见范围内的K线下标区间[first, last)，两端可能只露出半根
+ */
+void visibleRange(const CandlestickRenderer::Frame& frame, int *first, int *last)
+{
+    *first = qMax(0, qFloor(frame.viewFirst));
+    *last = qMin(frame.series.size(), qCeil(frame.viewFirst + frame.viewCount));
+}
+
+/**
+ * @brief 十字光标竖线的横坐标，K线足够宽时对齐到K线中心
+ */
+double crosshairX(const CandlestickRenderer::Frame& frame, const QRectF& plot, int index, double x)
+{
+    double barWidth = plot.width() / frame.viewCount;
+    if (barWidth < 1.0) {
+        return x;
+    }
+    return plot.left() + (index - frame.viewFirst + 0.5) * barWidth;
+}
+
+/**
+ * @brief 信息栏位置：价格区顶部两行文字
+ */
+QRectF infoRect(const CandlestickRenderer::Frame& frame, const QRectF& priceRect)
+{
+    QFontMetrics metrics(frame.font);
+    return QRectF(priceRect.left(), priceRect.top(), priceRect.width(), metrics.height() * 2 + kInfoPadding * 2);
+}
+
+} // namespace
+
+CandlestickRenderer::CandlestickRenderer()
+{
+}
+
+CandlestickRenderer::~CandlestickRenderer()
+{
+}
+
+CandlestickRenderer::Scale CandlestickRenderer::computeScale(const Frame& frame)
+{
+    Scale scale;
+
+    int first = 0;
+    int last = 0;
+    visibleRange(frame, &first, &last);
+    if (first >= last) {
+        return scale;
+    }
+
+    // 极值金字塔查询，与K线数量无关
+    int lowIndex = 0;
+    int highIndex = 0;
+    frame.series.priceRange(first, last, &lowIndex, &highIndex);
+
+    double minPrice = frame.series.low()[lowIndex];
+    double maxPrice = frame.series.high()[highIndex];
+
+    // 留一些边距，实时K线小幅波动时不必重绘静态层；
+    // 价格全部相同且为0（如停牌或无成交的占位数据）时给一个固定边距，避免价格区间为0
+    double padding = qMax((maxPrice - minPrice) * 0.05, qAbs(maxPrice) * 0.001);
+    if (padding <= 0.0) {
+        padding = 0.01;
+    }
+    scale.minPrice = minPrice - padding;
+    scale.maxPrice = maxPrice + padding;
+    scale.maxVolume = qMax(frame.series.maxVolume(first, last) * 1.1, 1.0);
+    return scale;
+}
+
+void CandlestickRenderer::computeLayout(const QSize& size, QRectF *priceRect, QRectF *volumeRect)
+{
+    QRectF plot = plotRect(size);
+
+    // 价格区占四分之三，成交量区占四分之一
+    double priceHeight = (plot.height() - kAreaSpacing) * 0.75;
+    *priceRect = QRectF(plot.left(), plot.top(), plot.width(), priceHeight);
+    *volumeRect = QRectF(plot.left(), priceRect->bottom() + kAreaSpacing,
+                         plot.width(), plot.height() - priceHeight - kAreaSpacing);
+}
+
+QRectF CandlestickRenderer::plotRect(const QSize& size)
+{
+    return QRectF(kLeftMargin, kTopMargin,
+                  size.width() - kLeftMargin - kRightMargin,
+                  size.height() - kTopMargin - kBottomMargin);
+}
+
+void CandlestickRenderer::renderStatic(QPainter& painter, const Frame& frame, const Scale& scale)
+{
+    QRect rect(QPoint(0, 0), frame.size);
+    painter.fillRect(rect, frame.baseColor);
+    painter.setFont(frame.font);
+
+    // 标题
+    painter.setPen(frame.textColor);
+    painter.drawText(QRect(0, 0, rect.width(), kTopMargin), Qt::AlignCenter, frame.title);
+
+    if (frame.series.isEmpty()) {
+        painter.drawText(rect, Qt::AlignCenter, frame.emptyText);
+        return;
+    }
+
+    QRectF priceRect;
+    QRectF volumeRect;
+    computeLayout(frame.size, &priceRect, &volumeRect);
+    if (priceRect.width() < 1 || priceRect.height() < 1 || frame.viewCount <= 0 || !scale.isValid()) {
+        return;
+    }
+
+    int first = 0;
+    int last = 0;
+    visibleRange(frame, &first, &last);
+
+    drawAxes(painter, frame, scale, priceRect, volumeRect, first, last);
+
+    // 最后一根K线属于实时层
+    int closedLast = frame.endsWithLive ? qMin(last, frame.series.size() - 1) : last;
+    collectBars(frame, scale, priceRect, volumeRect, first, closedLast);
+
+    painter.save();
+    painter.setClipRect(priceRect.united(volumeRect));
+    drawBars(painter);
+    drawMovingAverages(painter, frame, scale, priceRect, first, closedLast);
+    painter.restore();
+}
+
+void CandlestickRenderer::renderLive(QPainter& painter, const Frame& frame, const Scale& scale)
+{
+    if (frame.series.isEmpty() || frame.viewCount <= 0 || !scale.isValid()) {
+        return;
+    }
+
+    int first = 0;
+    int last = 0;
+    visibleRange(frame, &first, &last);
+
+    int liveIndex = frame.series.size() - 1;
+    if (liveIndex < first || liveIndex >= last) {
+        return;
+    }
+
+    QRectF priceRect;
+    QRectF volumeRect;
+    computeLayout(frame.size, &priceRect, &volumeRect);
+    if (priceRect.width() < 1 || priceRect.height() < 1) {
+        return;
+    }
+
+    collectBars(frame, scale, priceRect, volumeRect, liveIndex, liveIndex + 1);
+
+    painter.save();
+    painter.setClipRect(priceRect.united(volumeRect));
+    drawBars(painter);
+
+    // 均线的最后一段随实时K线变化
+    drawMovingAverages(painter, frame, scale, priceRect, qMax(first, liveIndex - 1), liveIndex + 1);
+    painter.restore();
+}
+
+int CandlestickRenderer::barAt(const Frame& frame, const QPointF& pos)
+{
+    QRectF plot = plotRect(frame.size);
+    if (frame.series.isEmpty() || frame.viewCount <= 0 || plot.width() < 1 || !plot.contains(pos)) {
+        return -1;
+    }
+
+    int index = qFloor(frame.viewFirst + (pos.x() - plot.left()) / plot.width() * frame.viewCount);
+    return qBound(0, index, frame.series.size() - 1);
+}
+
+QRegion CandlestickRenderer::crosshairRegion(const Frame& frame, const QPointF& pos)
+{
+    int index = barAt(frame, pos);
+    if (index < 0) {
+        return QRegion();
+    }
+
+    QRectF priceRect;
+    QRectF volumeRect;
+    computeLayout(frame.size, &priceRect, &volumeRect);
+    QRectF plot = priceRect.united(volumeRect);
+    double x = crosshairX(frame, plot, index, pos.x());
+
+    // 线宽1像素，各向外扩1像素以包含抗锯齿
+    QRegion region;
+    region += QRectF(x - 2, plot.top(), 4, plot.height()).toAlignedRect();
+    region += QRectF(plot.left(), pos.y() - 2, plot.width(), 4).toAlignedRect();
+    region += QRectF(0, pos.y() - 10, kLeftMargin, 20).toAlignedRect();
+    region += QRectF(x - 60, volumeRect.bottom(), 120, kBottomMargin).toAlignedRect();
+    region += infoRect(frame, priceRect).toAlignedRect();
+    return region;
+}
+
+void CandlestickRenderer::renderCrosshair(QPainter& painter, const Frame& frame, const Scale& scale, const QPointF& pos)
+{
+    int index = barAt(frame, pos);
+    if (index < 0 || !scale.isValid()) {
+        return;
+    }
+
+    QRectF priceRect;
+    QRectF volumeRect;
+    computeLayout(frame.size, &priceRect, &volumeRect);
+    QRectF plot = priceRect.united(volumeRect);
+    double x = crosshairX(frame, plot, index, pos.x());
+
+    painter.save();
+    painter.setFont(frame.font);
+    QFontMetrics metrics(frame.font);
+
+    // 十字线
+    painter.setPen(QPen(kCrosshairColor, 1, Qt::DashLine));
+    painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+    painter.drawLine(QPointF(plot.left(), pos.y()), QPointF(plot.right(), pos.y()));
+
+    // 纵轴标签：价格区显示价格，成交量区显示成交量
+    QString valueLabel;
+    if (priceRect.contains(pos)) {
+        double price = scale.minPrice + (priceRect.bottom() - pos.y()) / priceRect.height() * (scale.maxPrice - scale.minPrice);
+        valueLabel = QString::number(price, 'f', 2);
+    } else if (volumeRect.contains(pos)) {
+        double volume = (volumeRect.bottom() - pos.y()) / volumeRect.height() * scale.maxVolume;
+        valueLabel = QString::number(qint64(volume));
+    }
+    if (!valueLabel.isEmpty()) {
+        QRectF labelRect(0, pos.y() - 9, kLeftMargin - 1, 18);
+        painter.fillRect(labelRect, kCrosshairLabelColor);
+        painter.setPen(Qt::white);
+        painter.drawText(labelRect.adjusted(0, 0, -3, 0), Qt::AlignRight | Qt::AlignVCenter,
+                         metrics.elidedText(valueLabel, Qt::ElideLeft, kLeftMargin - 4));
+    }
+
+    // 时间轴标签（上海时间）
+    const OhlcvSeries& series = frame.series;
+    bool intraday = frame.timeFormat.contains("hh");
+    QString timeLabel = QDateTime::fromMSecsSinceEpoch(series.time()[index], TradingCalendar::timeZone())
+                            .toString(intraday ? "MM-dd hh:mm" : "yyyy-MM-dd");
+    double timeWidth = qMin(metrics.horizontalAdvance(timeLabel) + 8.0, 120.0);
+    QRectF timeRect(x - timeWidth / 2, volumeRect.bottom() + 1, timeWidth, kBottomMargin - 2);
+    painter.fillRect(timeRect, kCrosshairLabelColor);
+    painter.setPen(Qt::white);
+    painter.drawText(timeRect, Qt::AlignCenter, timeLabel);
+
+    // 信息栏：第一行开高低收和涨跌幅，第二行成交量和均线值
+    double open = series.open()[index];
+    double close = series.close()[index];
+    double previousClose = index > 0 ? series.close()[index - 1] : open;
+    double change = previousClose > 0 ? (close - previousClose) / previousClose * 100.0 : 0.0;
+
+    QRectF info = infoRect(frame, priceRect);
+    QColor background = frame.baseColor;
+    background.setAlpha(220);
+    painter.fillRect(info, background);
+    painter.setClipRect(info);
+
+    QString firstLine = QString("开 %1  高 %2  低 %3  收 %4  ")
+                            .arg(open, 0, 'f', 2)
+                            .arg(series.high()[index], 0, 'f', 2)
+                            .arg(series.low()[index], 0, 'f', 2)
+                            .arg(close, 0, 'f', 2);
+    QString changeText = QString("%1%2%").arg(change > 0 ? "+" : "").arg(change, 0, 'f', 2);
+
+    double textX = info.left() + kInfoPadding;
+    double firstY = info.top() + kInfoPadding + metrics.ascent();
+    painter.setPen(frame.textColor);
+    painter.drawText(QPointF(textX, firstY), firstLine);
+    painter.setPen(change > 0 ? kUpColor : change < 0 ? kDownColor : frame.textColor);
+    painter.drawText(QPointF(textX + metrics.horizontalAdvance(firstLine), firstY), changeText);
+
+    double secondY = firstY + metrics.height();
+    QString volumeText = QString("量 %1  ").arg(qint64(series.volume()[index]));
+    painter.setPen(frame.textColor);
+    painter.drawText(QPointF(textX, secondY), volumeText);
+    textX += metrics.horizontalAdvance(volumeText);
+
+    for (int n = 0; n < frame.movingAverages.size(); ++n) {
+        int period = frame.movingAverages[n];
+        double value = series.closeAverage(index + 1, period);
+        QString text = QString("MA%1 %2  ").arg(period)
+                           .arg(qIsNaN(value) ? QString("--") : QString::number(value, 'f', 2));
+        painter.setPen(kMovingAverageColors[n % 3]);
+        painter.drawText(QPointF(textX, secondY), text);
+        textX += metrics.horizontalAdvance(text);
+    }
+
+    painter.restore();
+}
+
+void CandlestickRenderer::drawAxes(QPainter& painter, const Frame& frame, const Scale& scale,
+                                   const QRectF& priceRect, const QRectF& volumeRect, int first, int last) const
+{
+    painter.setPen(kGridColor);
+    painter.drawRect(priceRect);
+    painter.drawRect(volumeRect);
+
+    // 价格网格和标签（5条）
+    const int priceTicks = 5;
+    for (int i = 0; i < priceTicks; ++i) {
+        double ratio = double(i) / (priceTicks - 1);
+        double y = priceRect.bottom() - ratio * priceRect.height();
+        double price = scale.minPrice + ratio * (scale.maxPrice - scale.minPrice);
+
+        painter.setPen(kGridColor);
+        painter.drawLine(QPointF(priceRect.left(), y), QPointF(priceRect.right(), y));
+
+        painter.setPen(frame.textColor);
+        painter.drawText(QRectF(0, y - 8, kLeftMargin - 4, 16), Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(price, 'f', 2));
+    }
+
+    // 时间标签（6个）
+    const int timeTicks = 6;
+    int count = last - first;
+    for (int i = 0; i < timeTicks && count > 0; ++i) {
+        int index = first + int(qint64(count - 1) * i / (timeTicks - 1));
+        double x = priceRect.left() + (index - frame.viewFirst + 0.5) * priceRect.width() / frame.viewCount;
+        if (x < priceRect.left() || x > priceRect.right()) {
+            continue;
+        }
+
+        QString label = QDateTime::fromMSecsSinceEpoch(frame.series.time()[index], TradingCalendar::timeZone())
+                            .toString(frame.timeFormat);
+
+        painter.drawText(QRectF(x - 40, volumeRect.bottom() + 2, 80, kBottomMargin - 2),
+                         Qt::AlignHCenter | Qt::AlignTop, label);
+    }
+}
+
+void CandlestickRenderer::collectBars(const Frame& frame, const Scale& scale,
+                                      const QRectF& priceRect, const QRectF& volumeRect, int first, int last)
+{
+    clearBars();
+    if (first >= last) {
+        return;
+    }
+
+    const OhlcvSeries& series = frame.series;
+    const double *open = series.open().constData();
+    const double *high = series.high().constData();
+    const double *low = series.low().constData();
+    const double *close = series.close().constData();
+    const double *volume = series.volume().constData();
+
+    double barWidth = priceRect.width() / frame.viewCount;
+
+    if (barWidth >= 1.0) {
+        // 每根K线至少一个像素宽，逐根绘制
+        double bodyWidth = qMax(1.0, barWidth * 0.7);
+        for (int i = first; i < last; ++i) {
+            double x = priceRect.left() + (i - frame.viewFirst + 0.5) * barWidth;
+            addBar(x, bodyWidth, open[i], high[i], low[i], close[i], volume[i],
+                   priceRect, volumeRect, scale.minPrice, scale.maxPrice, scale.maxVolume);
+        }
+        return;
+    }
+
+    // K线多于像素列时，每个像素列合并为一根K线：首开、尾收、最高、最低、成交量求和
+    int columns = qMax(1, int(priceRect.width()));
+    double barsPerColumn = frame.viewCount / columns;
+    for (int column = 0; column < columns; ++column) {
+        int begin = qMax(first, int(frame.viewFirst + barsPerColumn * column));
+        int end = qMin(last, int(frame.viewFirst + barsPerColumn * (column + 1)));
+        if (begin >= end) {
+            continue;
+        }
+
+        // 每列的最高、最低价和成交量合计直接查汇总数据，不逐根遍历
+        int lowIndex = 0;
+        int highIndex = 0;
+        series.priceRange(begin, end, &lowIndex, &highIndex);
+
+        double columnHigh = high[highIndex];
+        double columnLow = low[lowIndex];
+        double columnVolume = series.volumeSum(begin, end);
+
+        double x = priceRect.left() + column + 0.5;
+        addBar(x, 1.0, open[begin], columnHigh, columnLow, close[end - 1], columnVolume,
+               priceRect, volumeRect, scale.minPrice, scale.maxPrice, scale.maxVolume * barsPerColumn);
+    }
+}
+
+void CandlestickRenderer::addBar(double x, double width, double open, double high, double low, double close, double volume,
+                                 const QRectF& priceRect, const QRectF& volumeRect,
+                                 double minPrice, double maxPrice, double maxVolume)
+{
+    double priceScale = priceRect.height() / (maxPrice - minPrice);
+    auto priceToY = [&](double price) {
+        return priceRect.bottom() - (price - minPrice) * priceScale;
+    };
+
+    bool up = close >= open;
+
+    double bodyTop = priceToY(qMax(open, close));
+    double bodyHeight = qMax(1.0, priceToY(qMin(open, close)) - bodyTop);
+    QRectF body(x - width / 2, bodyTop, width, bodyHeight);
+    QLineF wick(x, priceToY(high), x, priceToY(low));
+
+    double volumeHeight = qMin(volumeRect.height(), volume / maxVolume * volumeRect.height());
+    QRectF volumeBar(x - width / 2, volumeRect.bottom() - volumeHeight, width, volumeHeight);
+
+    if (up) {
+        m_upBodies.append(body);
+        m_upWicks.append(wick);
+        m_upVolumes.append(volumeBar);
+    } else {
+        m_downBodies.append(body);
+        m_downWicks.append(wick);
+        m_downVolumes.append(volumeBar);
+    }
+}
+
+void CandlestickRenderer::drawMovingAverages(QPainter& painter, const Frame& frame, const Scale& scale,
+                                             const QRectF& priceRect, int first, int last)
+{
+    if (first >= last || frame.movingAverages.isEmpty()) {
+        return;
+    }
+
+    const OhlcvSeries& series = frame.series;
+    double priceScale = priceRect.height() / (scale.maxPrice - scale.minPrice);
+    double barWidth = priceRect.width() / frame.viewCount;
+    int columns = qMax(1, int(priceRect.width()));
+    double barsPerColumn = frame.viewCount / columns;
+
+    painter.setBrush(Qt::NoBrush);
+
+    for (int n = 0; n < frame.movingAverages.size(); ++n) {
+        int period = frame.movingAverages[n];
+        painter.setPen(kMovingAverageColors[n % 3]);
+        m_linePoints.clear();
+
+        // 均线值由收盘价累计和直接得到；K线不足周期时断开折线
+        auto addPoint = [&](double x, int end) {
+            double value = series.closeAverage(end, period);
+            if (qIsNaN(value)) {
+                if (m_linePoints.size() > 1) {
+                    painter.drawPolyline(m_linePoints);
+                }
+                m_linePoints.clear();
+                return;
+            }
+            m_linePoints.append(QPointF(x, priceRect.bottom() - (value - scale.minPrice) * priceScale));
+        };
+
+        if (barWidth >= 1.0) {
+            for (int i = first; i < last; ++i) {
+                addPoint(priceRect.left() + (i - frame.viewFirst + 0.5) * barWidth, i + 1);
+            }
+        } else {
+            // 合并显示时每个像素列取该列最后一根K线的均线值
+            for (int column = 0; column < columns; ++column) {
+                int begin = qMax(first, int(frame.viewFirst + barsPerColumn * column));
+                int end = qMin(last, int(frame.viewFirst + barsPerColumn * (column + 1)));
+                if (begin < end) {
+                    addPoint(priceRect.left() + column + 0.5, end);
+                }
+            }
+        }
+
+        if (m_linePoints.size() > 1) {
+            painter.drawPolyline(m_linePoints);
+        }
+    }
+}
+
+void CandlestickRenderer::drawBars(QPainter& painter) const
+{
+    // 影线
+    painter.setPen(kUpColor);
+    painter.drawLines(m_upWicks);
+    painter.setPen(kDownColor);
+    painter.drawLines(m_downWicks);
+
+    // 实体和成交量柱
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(kUpColor);
+    painter.drawRects(m_upBodies);
+    painter.drawRects(m_upVolumes);
+    painter.setBrush(kDownColor);
+    painter.drawRects(m_downBodies);
+    painter.drawRects(m_downVolumes);
+}
+
+void CandlestickRenderer::clearBars()
+{
+    m_upBodies.clear();
+    m_downBodies.clear();
+    m_upWicks.clear();
+    m_downWicks.clear();
+    m_upVolumes.clear();
+    m_downVolumes.clear();
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "../data/ohlcvseries.h"
+#include <QVector>
+#include <QRectF>
+#include <QRegion>
+#include <QLineF>
+#include <QPolygonF>
+#include <QSize>
+#include <QColor>
+#include <QFont>
+#include <QMetaType>
+
+class QPainter;
+
+/**
+ * @brief K线图绘制器
+ *
+ * 不依赖控件，可以在工作线程中向QImage绘制。
+ * 图表分为两层：静态层包含背景、标题、网格、坐标轴标签、已收盘的K线及其均线，
+ * 实时层只有最后一根（仍在变化的）K线和均线的最后一段。两层使用同一坐标比例，
+ * 实时K线超出比例范围时静态层需要重绘。十字光标绘制在最上面，只影响光标所在的几个条带
+ */
+class CandlestickRenderer
+{
+public:
+    /**
+     * @brief 一帧的绘制参数
+     */
+    struct Frame {
+        OhlcvSeries series;      // K线数据（GUI线程上隐式共享；交给工作线程的是可见窗口的副本）
+        bool endsWithLive = true;  // series的最后一根是否为实时K线，窗口副本不含实时K线时为false
+        double viewFirst = 0.0;  // 第一根可见K线的下标
+        double viewCount = 0.0;  // 可见K线数量
+        QSize size;              // 绘制区域大小
+        QString title;           // 标题
+        QString timeFormat;      // 时间轴标签格式
+        QString emptyText;       // 无数据时的提示
+        QColor baseColor;        // 背景色
+        QColor textColor;        // 文字颜色
+        QFont font;              // 字体
+        QVector<int> movingAverages;  // 叠加的收盘价均线周期，如5、10、20
+    };
+
+    /**
+     * @brief 坐标比例
+     */
+    struct Scale {
+        double minPrice = 0.0;
+        double maxPrice = 0.0;
+        double maxVolume = 0.0;
+
+        bool isValid() const { return maxPrice > minPrice; }
+
+        /**
+         * @brief 一根K线是否落在比例范围内
+         */
+        bool contains(double low, double high, double volume) const
+        {
+            return low >= minPrice && high <= maxPrice && volume <= maxVolume;
+        }
+    };
+
+    CandlestickRenderer();
+    ~CandlestickRenderer();
+
+    /**
+     * @brief 计算可见范围的坐标比例（含实时K线）
+     */
+    static Scale computeScale(const Frame& frame);
+
+    /**
+     * @brief 计算价格区和成交量区的位置
+     */
+    static void computeLayout(const QSize& size, QRectF *priceRect, QRectF *volumeRect);
+
+    /**
+     * @brief K线绘图区（价格区与成交量区合并）
+     */
+    static QRectF plotRect(const QSize& size);
+
+    /**
+     * @brief 绘制静态层：背景、标题、坐标轴和除最后一根外的可见K线
+     */
+    void renderStatic(QPainter& painter, const Frame& frame, const Scale& scale);
+
+    /**
+     * @brief 绘制实时层：最后一根K线（不可见时不绘制）
+     */
+    void renderLive(QPainter& painter, const Frame& frame, const Scale& scale);
+
+    /**
+     * @brief 指定位置所在的K线下标
+     *
+     * 横轴按K线下标等分，由横坐标直接换算，与K线数量无关
+     * @return 不在绘图区或没有K线时返回-1
+     */
+    static int barAt(const Frame& frame, const QPointF& pos);
+
+    /**
+     * @brief 十字光标在指定位置时覆盖的区域（竖线、横线、坐标标签和信息栏）
+     */
+    static QRegion crosshairRegion(const Frame& frame, const QPointF& pos);
+
+    /**
+     * @brief 绘制十字光标和所指K线的开高低收、涨跌幅、成交量及均线值
+     */
+    void renderCrosshair(QPainter& painter, const Frame& frame, const Scale& scale, const QPointF& pos);
+
+private:
+    /**
+     * @brief 绘制网格和坐标轴标签
+     */
+    void drawAxes(QPainter& painter, const Frame& frame, const Scale& scale,
+                  const QRectF& priceRect, const QRectF& volumeRect, int first, int last) const;
+
+    /**
+     * @brief 收集[first, last)内K线的绘制图元
+     */
+    void collectBars(const Frame& frame, const Scale& scale,
+                     const QRectF& priceRect, const QRectF& volumeRect, int first, int last);
+
+    /**
+     * @brief 收集一根（或一个像素列合并后的）K线
+     */
+    void addBar(double x, double width, double open, double high, double low, double close, double volume,
+                const QRectF& priceRect, const QRectF& volumeRect,
+                double minPrice, double maxPrice, double maxVolume);
+
+    /**
+     * @brief 绘制[first, last)内K线的均线
+     */
+    void drawMovingAverages(QPainter& painter, const Frame& frame, const Scale& scale,
+                            const QRectF& priceRect, int first, int last);
+
+    /**
+     * @brief 批量绘制收集到的图元
+     */
+    void drawBars(QPainter& painter) const;
+
+    /**
+     * @brief 清空图元缓冲区
+     */
+    void clearBars();
+
+private:
+    // 每帧复用的图元缓冲区，按涨跌分组
+    QVector<QRectF> m_upBodies;       // 阳线实体
+    QVector<QRectF> m_downBodies;     // 阴线实体
+    QVector<QLineF> m_upWicks;        // 阳线影线
+    QVector<QLineF> m_downWicks;      // 阴线影线
+    QVector<QRectF> m_upVolumes;      // 阳线成交量
+    QVector<QRectF> m_downVolumes;    // 阴线成交量
+    QPolygonF m_linePoints;           // 均线折线
+};
+
+Q_DECLARE_METATYPE(CandlestickRenderer::Scale)
\ No newline at end of file
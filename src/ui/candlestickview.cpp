@@ -0,0 +1,370 @@
+#include "candlestickview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <algorithm>
+
+namespace {
+
+const int kMinVisibleBars = 10;        // 最大放大时的可见K线数量
+const int kDefaultVisibleBars = 120;   // 默认可见K线数量
+const int kMaxBarsPerPixel = 4;        // 最大缩小时每个像素列合并的K线数量
+const double kZoomStep = 0.8;          // 滚轮每格的缩放系数
+
+} // namespace
+
+CandlestickView::CandlestickView(QWidget *parent)
+    : QWidget(parent)
+    , m_timeFormat("MM-dd")
+    , m_viewFirst(0.0)
+    , m_viewCount(0.0)
+    , m_followLatest(true)
+    , m_dragging(false)
+    , m_dragStartFirst(0.0)
+    , m_crosshairVisible(false)
+    , m_layerWorker(new ChartLayerWorker())
+    , m_layerCharge(MemoryAccounting::ChartLayerTag)
+    , m_layerRevision(1)
+    , m_renderedRevision(0)
+    , m_layerRequested(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(200, 150);
+    setMouseTracking(true);
+
+    // 静态层在独立线程中绘制，结果以排队方式交回GUI线程
+    m_layerThread.setObjectName("chart-layer");
+    m_layerWorker->moveToThread(&m_layerThread);
+    connect(&m_layerThread, &QThread::finished, m_layerWorker, &QObject::deleteLater);
+    connect(m_layerWorker, &ChartLayerWorker::layerReady, this, &CandlestickView::onLayerReady);
+    m_layerThread.start();
+}
+
+CandlestickView::~CandlestickView()
+{
+    m_layerThread.quit();
+    m_layerThread.wait();
+}
+
+void CandlestickView::setSeries(const OhlcvSeries& series)
+{
+    // 新数据默认显示最近的一段
+    double count = qMin<double>(series.size(), kDefaultVisibleBars);
+    setSeries(series, series.size() - count, count);
+}
+
+void CandlestickView::setSeries(const OhlcvSeries& series, double first, double count)
+{
+    m_series = series;
+
+    // 总是通知外部重新评估历史加载
+    m_viewCount = -1.0;
+    setViewport(first, count);
+    invalidateLayer();
+}
+
+void CandlestickView::updateLastBar(const StockTradeData& data)
+{
+    if (m_series.isEmpty()) {
+        return;
+    }
+
+    m_series.replaceLast(data);
+
+    // 实时K线仍在静态层的坐标范围内时只重绘实时层
+    if (m_layerScale.contains(data.low, data.high, double(data.volume))) {
+        update();
+    } else {
+        invalidateLayer();
+    }
+}
+
+void CandlestickView::appendBar(const StockTradeData& data)
+{
+    m_series.append(data);
+
+    // 跟随最新K线时向右滚动一根
+    if (m_followLatest) {
+        setViewport(m_viewFirst + 1, m_viewCount);
+    }
+
+    // 原来的最后一根K线已收盘，进入静态层
+    invalidateLayer();
+}
+
+void CandlestickView::prependBars(const OhlcvSeries& older)
+{
+    if (older.isEmpty()) {
+        return;
+    }
+
+    m_series.prepend(older);
+
+    // 拖动中的锚点随K线一起平移，否则下一次移动会按旧锚点跳动
+    m_dragStartFirst += older.size();
+    setViewport(m_viewFirst + older.size(), m_viewCount);
+    invalidateLayer();
+}
+
+void CandlestickView::removeFirstBars(int count)
+{
+    count = qMin(count, m_series.size());
+    if (count <= 0) {
+        return;
+    }
+
+    m_series.removeFirst(count);
+    m_dragStartFirst -= count;
+    setViewport(m_viewFirst - count, m_viewCount);
+    invalidateLayer();
+}
+
+void CandlestickView::setViewport(double first, double count)
+{
+    count = boundedCount(count);
+    first = qBound(0.0, first, qMax(0.0, m_series.size() - count));
+
+    bool changed = !qFuzzyCompare(first + 1.0, m_viewFirst + 1.0) || !qFuzzyCompare(count + 1.0, m_viewCount + 1.0);
+    m_viewFirst = first;
+    m_viewCount = count;
+    m_followLatest = first + count >= m_series.size() - 0.001;
+
+    if (changed) {
+        invalidateLayer();
+        emit viewportChanged(firstVisibleBar(), visibleBarCount());
+    }
+}
+
+double CandlestickView::boundedCount(double count) const
+{
+    double minCount = qMin<double>(kMinVisibleBars, m_series.size());
+    double maxCount = m_series.size();
+
+    // 未显示时宽度还未确定，不按像素限制
+    if (isVisible()) {
+        maxCount = qMin(maxCount, qMax(1.0, plotWidth()) * kMaxBarsPerPixel);
+    }
+    return qBound(minCount, count, qMax(minCount, maxCount));
+}
+
+void CandlestickView::zoomAt(double ratio, double factor)
+{
+    double anchor = m_viewFirst + ratio * m_viewCount;
+    double count = boundedCount(m_viewCount * factor);
+    setViewport(anchor - ratio * count, count);
+}
+
+double CandlestickView::plotWidth() const
+{
+    return CandlestickRenderer::plotRect(size()).width();
+}
+
+void CandlestickView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    // 变窄后重新限制可见数量
+    setViewport(m_viewFirst, m_viewCount);
+    invalidateLayer();
+}
+
+void CandlestickView::wheelEvent(QWheelEvent *event)
+{
+    if (m_series.isEmpty() || plotWidth() < 1) {
+        event->ignore();
+        return;
+    }
+
+    double steps = event->angleDelta().y() / 120.0;
+    double ratio = qBound(0.0, (event->position().x() - CandlestickRenderer::plotRect(size()).left()) / plotWidth(), 1.0);
+    zoomAt(ratio, qPow(kZoomStep, steps));
+    event->accept();
+}
+
+void CandlestickView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = true;
+        m_dragStartPos = event->pos();
+        m_dragStartFirst = m_viewFirst;
+        setCursor(Qt::ClosedHandCursor);
+        moveCrosshair(event->pos(), false);
+        event->accept();
+        return;
+    }
+
+    QWidget::mousePressEvent(event);
+}
+
+void CandlestickView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_dragging && plotWidth() >= 1) {
+        // 向右拖动查看更早的K线
+        double barsPerPixel = m_viewCount / plotWidth();
+        setViewport(m_dragStartFirst - (event->pos().x() - m_dragStartPos.x()) * barsPerPixel, m_viewCount);
+        event->accept();
+        return;
+    }
+
+    moveCrosshair(event->pos(), true);
+    QWidget::mouseMoveEvent(event);
+}
+
+void CandlestickView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (m_dragging && event->button() == Qt::LeftButton) {
+        m_dragging = false;
+        unsetCursor();
+        moveCrosshair(event->pos(), true);
+        event->accept();
+        return;
+    }
+
+    QWidget::mouseReleaseEvent(event);
+}
+
+void CandlestickView::leaveEvent(QEvent *event)
+{
+    moveCrosshair(m_crosshairPos, false);
+    QWidget::leaveEvent(event);
+}
+
+void CandlestickView::moveCrosshair(const QPoint& pos, bool visible)
+{
+    if (visible == m_crosshairVisible && (!visible || pos == m_crosshairPos)) {
+        return;
+    }
+
+    // 十字光标画在静态层之上，重绘时只需重新合成旧光标和新光标覆盖的条带
+    CandlestickRenderer::Frame frame = currentFrame();
+    QRegion dirty;
+    if (m_crosshairVisible) {
+        dirty += CandlestickRenderer::crosshairRegion(frame, m_crosshairPos);
+    }
+    m_crosshairVisible = visible;
+    m_crosshairPos = pos;
+    if (m_crosshairVisible) {
+        dirty += CandlestickRenderer::crosshairRegion(frame, m_crosshairPos);
+    }
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void CandlestickView::setTitle(const QString& title)
+{
+    m_title = title;
+    invalidateLayer();
+}
+
+void CandlestickView::setTimeFormat(const QString& format)
+{
+    m_timeFormat = format;
+    invalidateLayer();
+}
+
+void CandlestickView::setMovingAverages(const QVector<int>& periods)
+{
+    m_movingAverages = periods;
+    invalidateLayer();
+}
+
+void CandlestickView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+
+    // 静态层过期时向工作线程请求重绘，新图层到达前继续使用旧图层
+    if (m_renderedRevision != m_layerRevision) {
+        requestLayer();
+    }
+
+    if (m_layer.isNull()) {
+        painter.fillRect(rect(), palette().base());
+        return;
+    }
+
+    painter.drawImage(0, 0, m_layer);
+
+    // 实时K线使用静态层的坐标比例绘制
+    CandlestickRenderer::Frame frame = currentFrame();
+    m_liveRenderer.renderLive(painter, frame, m_layerScale);
+
+    if (m_crosshairVisible && !m_dragging) {
+        m_liveRenderer.renderCrosshair(painter, frame, m_layerScale, m_crosshairPos);
+    }
+}
+
+CandlestickRenderer::Frame CandlestickView::currentFrame() const
+{
+    CandlestickRenderer::Frame frame;
+    frame.series = m_series;
+    frame.viewFirst = m_viewFirst;
+    frame.viewCount = m_viewCount;
+    frame.size = size();
+    frame.title = m_title;
+    frame.timeFormat = m_timeFormat;
+    frame.emptyText = tr("无K线数据");
+    frame.baseColor = palette().base().color();
+    frame.textColor = palette().text().color();
+    frame.font = font();
+    frame.movingAverages = m_movingAverages;
+    return frame;
+}
+
+CandlestickRenderer::Frame CandlestickView::layerFrame() const
+{
+    CandlestickRenderer::Frame frame = currentFrame();
+
+    // 第一根可见K线的均线需要它之前period-1根K线
+    int lead = 0;
+    if (!m_movingAverages.isEmpty()) {
+        lead = qMax(0, *std::max_element(m_movingAverages.cbegin(), m_movingAverages.cend()) - 1);
+    }
+    int begin = qMax(0, qFloor(m_viewFirst) - lead);
+    int end = qMin(m_series.size(), qCeil(m_viewFirst + m_viewCount));
+
+    frame.series = m_series.mid(begin, end);
+    frame.viewFirst = m_viewFirst - begin;
+    frame.endsWithLive = end == m_series.size();
+    return frame;
+}
+
+void CandlestickView::invalidateLayer()
+{
+    ++m_layerRevision;
+    update();
+}
+
+void CandlestickView::requestLayer()
+{
+    if (m_layerRequested) {
+        return;
+    }
+
+    m_layerRequested = true;
+
+    ChartLayerWorker *worker = m_layerWorker;
+    quint64 revision = m_layerRevision;
+    CandlestickRenderer::Frame frame = layerFrame();
+    qreal devicePixelRatio = devicePixelRatioF();
+
+    QMetaObject::invokeMethod(worker, [worker, revision, frame, devicePixelRatio]() {
+        worker->renderLayer(revision, frame, devicePixelRatio);
+    }, Qt::QueuedConnection);
+}
+
+void CandlestickView::onLayerReady(quint64 revision, const QImage& image, const CandlestickRenderer::Scale& scale)
+{
+    m_layerRequested = false;
+    m_layer = image;
+    m_layerCharge.set(m_layer.sizeInBytes());
+    m_layerScale = scale;
+    m_renderedRevision = revision;
+
+    // 绘制期间又有变化时，下一次绘制会再次请求
+    update();
+}
\ No newline at end of file
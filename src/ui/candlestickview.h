@@ -0,0 +1,254 @@
+#pragma once
+
+#include "../data/ohlcvseries.h"
+#include "../data/memoryaccounting.h"
+#include "candlestickrenderer.h"
+#include "chartlayerworker.h"
+#include <QWidget>
+#include <QThread>
+#include <QImage>
+#include <QPoint>
+#include <QtMath>
+
+/**
+ * @brief K线图绘制控件
+ *
+ * 用CandlestickRenderer从列式K线数据绘制K线和成交量。
+ * 背景、坐标轴和已收盘的K线构成静态层，由工作线程绘制到QImage并缓存，
+ * 只有可见范围、尺寸或已收盘K线变化时才重绘；GUI线程每帧只合成静态层
+ * 并绘制最后一根实时K线，行情推送不会触发整图重绘。
+ *
+ * 支持滚轮缩放和拖动平移，可见范围以（可带小数的）K线下标表示；
+ * 可见范围变化时发出viewportChanged，由外部按需在前面补充或释放历史K线。
+ * 鼠标悬停时显示十字光标和所指K线的信息，移动光标只重绘光标前后覆盖的条带
+ */
+class CandlestickView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CandlestickView(QWidget *parent = nullptr);
+    ~CandlestickView();
+
+    /**
+     * @brief 设置K线数据
+     * @param series K线数据
+     */
+    void setSeries(const OhlcvSeries& series);
+
+    /**
+     * @brief 设置K线数据并指定可见范围（从缓存恢复图表时使用）
+     * @param series K线数据
+     * @param first 第一根可见K线的下标
+     * @param count 可见K线数量
+     */
+    void setSeries(const OhlcvSeries& series, double first, double count);
+
+    /**
+     * @brief 获取K线数据
+     */
+    const OhlcvSeries& series() const { return m_series; }
+
+    /**
+     * @brief 更新最后一根K线
+     * @param data K线数据
+     */
+    void updateLastBar(const StockTradeData& data);
+
+    /**
+     * @brief 追加一根K线
+     * @param data K线数据
+     */
+    void appendBar(const StockTradeData& data);
+
+    /**
+     * @brief 在前面插入更早的K线，可见范围保持不动
+     * @param older 更早的K线
+     */
+    void prependBars(const OhlcvSeries& older);
+
+    /**
+     * @brief 删除前面的K线，可见范围保持不动
+     * @param count 删除数量
+     */
+    void removeFirstBars(int count);
+
+    /**
+     * @brief 第一根可见K线的下标
+     */
+    int firstVisibleBar() const { return int(m_viewFirst); }
+
+    /**
+     * @brief 可见K线数量
+     */
+    int visibleBarCount() const { return qCeil(m_viewCount); }
+
+    /**
+     * @brief 设置标题
+     * @param title 标题
+     */
+    void setTitle(const QString& title);
+
+    /**
+     * @brief 获取标题
+     */
+    QString title() const { return m_title; }
+
+    /**
+     * @brief 设置时间轴标签格式
+     * @param format 时间格式，如"MM-dd"、"hh:mm"
+     */
+    void setTimeFormat(const QString& format);
+
+    /**
+     * @brief 获取时间轴标签格式
+     */
+    QString timeFormat() const { return m_timeFormat; }
+
+    /**
+     * @brief 设置叠加的收盘价均线
+     * @param periods 均线周期，如{5, 10, 20}，为空时不显示
+     */
+    void setMovingAverages(const QVector<int>& periods);
+
+    /**
+     * @brief 第一根可见K线的精确下标
+     */
+    double viewFirst() const { return m_viewFirst; }
+
+    /**
+     * @brief 精确的可见K线数量
+     */
+    double viewCount() const { return m_viewCount; }
+
+signals:
+    /**
+     * @brief 可见范围变化信号
+     * @param firstBar 第一根可见K线的下标
+     * @param barCount 可见K线数量
+     */
+    void viewportChanged(int firstBar, int barCount);
+
+protected:
+    /**
+     * @brief 绘制图表
+     */
+    void paintEvent(QPaintEvent *event) override;
+
+    /**
+     * @brief 尺寸变化时重新限制可见范围
+     */
+    void resizeEvent(QResizeEvent *event) override;
+
+    /**
+     * @brief 滚轮缩放，以鼠标所在位置为中心
+     */
+    void wheelEvent(QWheelEvent *event) override;
+
+    /**
+     * @brief 鼠标拖动平移
+     */
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+    /**
+     * @brief 鼠标离开时隐藏十字光标
+     */
+    void leaveEvent(QEvent *event) override;
+
+private:
+    /**
+     * @brief 设置可见范围，限制在合法区间内并通知外部
+     * @param first 第一根可见K线的下标
+     * @param count 可见K线数量
+     */
+    void setViewport(double first, double count);
+
+    /**
+     * @brief 将可见K线数量限制在合法区间内
+     *
+     * 至少显示kMinVisibleBars根；缩小时每个像素列最多合并kMaxBarsPerPixel根，
+     * 更长的时间跨度应切换到更大的K线周期，保证加载的数据量与窗口宽度成正比
+     */
+    double boundedCount(double count) const;
+
+    /**
+     * @brief 以可见范围内的相对位置为中心缩放
+     * @param ratio 缩放中心在可见范围内的相对位置（0~1）
+     * @param factor 缩放系数，小于1为放大
+     */
+    void zoomAt(double ratio, double factor);
+
+    /**
+     * @brief K线绘图区宽度
+     */
+    double plotWidth() const;
+
+    /**
+     * @brief 当前的绘制参数
+     */
+    CandlestickRenderer::Frame currentFrame() const;
+
+    /**
+     * @brief 交给工作线程的绘制参数
+     *
+     * 只含可见窗口及均线所需的前导K线的独立副本，绘制期间实时K线更新不会使GUI线程复制整条序列
+     */
+    CandlestickRenderer::Frame layerFrame() const;
+
+    /**
+     * @brief 使静态层失效并安排重绘
+     */
+    void invalidateLayer();
+
+    /**
+     * @brief 向工作线程请求绘制静态层，已有请求在途时等其返回后再发
+     */
+    void requestLayer();
+
+    /**
+     * @brief 移动或隐藏十字光标，只重绘新旧光标覆盖的区域
+     * @param pos 光标位置
+     * @param visible 是否显示
+     */
+    void moveCrosshair(const QPoint& pos, bool visible);
+
+private slots:
+    /**
+     * @brief 静态层绘制完成
+     */
+    void onLayerReady(quint64 revision, const QImage& image, const CandlestickRenderer::Scale& scale);
+
+private:
+    OhlcvSeries m_series;        // K线数据
+    QString m_title;             // 标题
+    QString m_timeFormat;        // 时间轴标签格式
+    QVector<int> m_movingAverages;  // 均线周期
+
+    // 可见范围
+    double m_viewFirst;          // 第一根可见K线的下标（可带小数，平移更平滑）
+    double m_viewCount;          // 可见K线数量
+    bool m_followLatest;         // 是否跟随最新K线
+
+    // 拖动状态
+    bool m_dragging;
+    QPoint m_dragStartPos;
+    double m_dragStartFirst;
+
+    // 十字光标
+    bool m_crosshairVisible;
+    QPoint m_crosshairPos;
+
+    // 静态层（在工作线程中绘制）
+    QThread m_layerThread;                      // 绘制线程
+    ChartLayerWorker *m_layerWorker;            // 绘制工作对象
+    QImage m_layer;                             // 静态层图像
+    MemoryCharge m_layerCharge;                 // 静态层图像的内存登记
+    CandlestickRenderer::Scale m_layerScale;    // 静态层的坐标比例
+    quint64 m_layerRevision;                    // 静态层当前应有的版本
+    quint64 m_renderedRevision;                 // m_layer对应的版本
+    bool m_layerRequested;                      // 是否有绘制请求在途
+
+    CandlestickRenderer m_liveRenderer;         // GUI线程绘制实时K线
+};
\ No newline at end of file
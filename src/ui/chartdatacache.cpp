@@ -0,0 +1,57 @@
+#include "chartdatacache.h"
+
+qint64 ChartRenderData::byteSize() const
+{
+    return series.byteSize()
+         + qint64(pricePoints.size() + averagePoints.size()) * sizeof(QPointF)
+         + qint64(volumes.size()) * sizeof(qreal)
+         + qint64(timeSeries.size()) * sizeof(TimeSeriesPoint)
+         + qint64(sessionDays.size()) * sizeof(QDate)
+         + qint64(historyChunkSizes.size()) * sizeof(int)
+         + sizeof(ChartRenderData);
+}
+
+ChartDataCache::ChartDataCache(int budgetKB)
+    : m_entries(budgetKB)
+    , m_charge(MemoryAccounting::ChartLayerTag)
+{
+}
+
+ChartDataCache::~ChartDataCache()
+{
+}
+
+QString ChartDataCache::key(const QString& code, int chartType, int periodType)
+{
+    return QString("%1|%2|%3").arg(code).arg(chartType).arg(periodType);
+}
+
+void ChartDataCache::setBudget(int budgetKB)
+{
+    m_entries.setMaxCost(budgetKB);
+    m_charge.set(byteSize());
+}
+
+void ChartDataCache::insert(const QString& key, const ChartRenderData& data)
+{
+    int cost = int(data.byteSize() / 1024) + 1;
+    m_entries.insert(key, new ChartRenderData(data), cost);
+    m_charge.set(byteSize());
+}
+
+const ChartRenderData* ChartDataCache::find(const QString& key)
+{
+    return m_entries.object(key);
+}
+
+void ChartDataCache::remove(const QString& key)
+{
+    m_entries.remove(key);
+    m_charge.set(byteSize());
+}
+
+void ChartDataCache::clear()
+{
+    m_entries.clear();
+    m_charge.set(byteSize());
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../data/ohlcvseries.h"
+#include "../data/memoryaccounting.h"
+#include <QCache>
+#include <QDate>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 一个图表已准备好的绘制数据
+ *
+ * K线图保存含汇总数据（极值金字塔、累计和，均线由此直接计算）的K线序列、
+ * 可见范围和已加载的历史块；分时图保存多日拼接的分时数据、降采样后的价格点、均价点、成交量和坐标轴范围
+ */
+struct ChartRenderData {
+    QString title;                   // 标题
+
+    // K线图
+    OhlcvSeries series;              // K线数据（含历史块）
+    QString timeFormat;              // 时间轴标签格式
+    double viewFirst = 0.0;          // 第一根可见K线的下标
+    double viewCount = 0.0;          // 可见K线数量
+    QVector<int> historyChunkSizes;  // 已加载的历史块大小
+    bool historyExhausted = false;   // 是否已没有更早的历史
+
+    // 分时图（横坐标为交易时段压缩后的位置）
+    QVector<QDate> sessionDays;      // 时间轴包含的交易日
+    QVector<TimeSeriesPoint> timeSeries;  // 完整分时数据（多日拼接，十字光标读数用）
+    int intradayHistoryPoints = 0;   // 其中往日分时的点数
+    QList<QPointF> pricePoints;      // 价格点（可能已降采样）
+    QList<QPointF> averagePoints;    // 均价点（与价格点取相同的下标）
+    QList<qreal> volumes;            // 成交量柱（按时间轴位置，降采样时按列合计）
+    double minPrice = 0.0;           // 价格轴范围
+    double maxPrice = 0.0;
+    double maxVolume = 0.0;          // 成交量轴上限
+    int decimationColumns = 0;       // 价格点按多少像素列降采样，0表示未降采样
+
+    /**
+     * @brief 估算占用的内存字节数
+     */
+    qint64 byteSize() const;
+};
+
+/**
+ * @brief 图表绘制数据缓存
+ *
+ * 以（股票代码, 图表类型, 周期）为键缓存已准备好的绘制数据，按内存预算LRU淘汰；
+ * 在最近看过的股票和周期之间切换时直接从缓存恢复，不必重新转换和降采样
+ */
+class ChartDataCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param budgetKB 内存预算（KB）
+     */
+    explicit ChartDataCache(int budgetKB = 32 * 1024);
+    ~ChartDataCache();
+
+    /**
+     * @brief 生成缓存键
+     * @param code 股票代码
+     * @param chartType 图表类型
+     * @param periodType K线周期，分时图传-1
+     */
+    static QString key(const QString& code, int chartType, int periodType);
+
+    /**
+     * @brief 设置内存预算
+     * @param budgetKB 内存预算（KB）
+     */
+    void setBudget(int budgetKB);
+
+    /**
+     * @brief 放入缓存，超出预算时淘汰最久未使用的数据
+     */
+    void insert(const QString& key, const ChartRenderData& data);
+
+    /**
+     * @brief 查找缓存，命中时标记为最近使用
+     * @return 缓存的数据，未命中时返回nullptr；下次insert后指针可能失效
+     */
+    const ChartRenderData* find(const QString& key);
+
+    /**
+     * @brief 移除一项缓存
+     */
+    void remove(const QString& key);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 缓存数据占用的内存字节数（按放入时的估算）
+     */
+    qint64 byteSize() const { return qint64(m_entries.totalCost()) * 1024; }
+
+private:
+    QCache<QString, ChartRenderData> m_entries;  // 开销按KB计
+    MemoryCharge m_charge;                       // 缓存的内存登记
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "chartlayerworker.h"
+#include "../data/tracer.h"
+#include <QPainter>
+
+ChartLayerWorker::ChartLayerWorker(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<CandlestickRenderer::Scale>();
+}
+
+ChartLayerWorker::~ChartLayerWorker()
+{
+}
+
+void ChartLayerWorker::renderLayer(quint64 revision, const CandlestickRenderer::Frame& frame, qreal devicePixelRatio)
+{
+    TRACE_SCOPE("ChartLayerWorker::renderLayer");
+    CandlestickRenderer::Scale scale = CandlestickRenderer::computeScale(frame);
+
+    QImage image(frame.size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    if (!image.isNull()) {
+        QPainter painter(&image);
+        m_renderer.renderStatic(painter, frame, scale);
+    }
+
+    emit layerReady(revision, image, scale);
+}
\ No newline at end of file
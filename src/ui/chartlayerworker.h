@@ -0,0 +1,39 @@
+#pragma once
+
+#include "candlestickrenderer.h"
+#include <QObject>
+#include <QImage>
+
+/**
+ * @brief K线图静态层绘制工作对象
+ *
+ * 运行在独立线程中，把静态层绘制到QImage后通过信号交回GUI线程
+ */
+class ChartLayerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ChartLayerWorker(QObject *parent = nullptr);
+    ~ChartLayerWorker();
+
+    /**
+     * @brief 绘制静态层（在工作线程中调用）
+     * @param revision 请求版本号，随结果原样返回
+     * @param frame 绘制参数
+     * @param devicePixelRatio 设备像素比
+     */
+    void renderLayer(quint64 revision, const CandlestickRenderer::Frame& frame, qreal devicePixelRatio);
+
+signals:
+    /**
+     * @brief 静态层绘制完成信号
+     * @param revision 请求版本号
+     * @param image 静态层图像
+     * @param scale 绘制时使用的坐标比例
+     */
+    void layerReady(quint64 revision, const QImage& image, const CandlestickRenderer::Scale& scale);
+
+private:
+    CandlestickRenderer m_renderer;  // 工作线程专用的绘制器
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "flashanimator.h"
+
+FlashAnimator::FlashAnimator(QObject *parent)
+    : QObject(parent)
+    , m_maxActiveCells(256)
+    , m_droppedCount(0)
+{
+    m_frameTimer.setInterval(kFrameInterval);
+    connect(&m_frameTimer, &QTimer::timeout, this, &FlashAnimator::onFrameTimer);
+}
+
+FlashAnimator::~FlashAnimator()
+{
+}
+
+void FlashAnimator::resize(int count)
+{
+    m_levels.fill(0, count);
+    m_activeCells.clear();
+    m_frameTimer.stop();
+}
+
+void FlashAnimator::trigger(int cell, int direction)
+{
+    if (cell < 0 || cell >= m_levels.size() || direction == 0) {
+        return;
+    }
+
+    // 未在闪烁的单元格需要占用一个名额
+    if (m_levels[cell] == 0) {
+        if (m_activeCells.size() >= m_maxActiveCells) {
+            m_droppedCount++;
+            return;
+        }
+        m_activeCells.append(cell);
+    }
+
+    m_levels[cell] = qint8(direction > 0 ? kFadeFrames : -kFadeFrames);
+
+    if (!m_frameTimer.isActive()) {
+        m_frameTimer.start();
+    }
+}
+
+qreal FlashAnimator::intensity(int cell) const
+{
+    if (cell < 0 || cell >= m_levels.size()) {
+        return 0.0;
+    }
+
+    return qreal(m_levels[cell]) / kFadeFrames;
+}
+
+void FlashAnimator::setMaxActiveCells(int count)
+{
+    m_maxActiveCells = qMax(0, count);
+}
+
+void FlashAnimator::onFrameTimer()
+{
+    m_changedCells.clear();
+
+    // 所有闪烁一起衰减一帧，结束的单元格从活动列表中移除
+    for (int i = 0; i < m_activeCells.size(); ) {
+        int cell = m_activeCells[i];
+        qint8& level = m_levels[cell];
+        level += (level > 0) ? -1 : 1;
+        m_changedCells.append(cell);
+
+        if (level == 0) {
+            m_activeCells[i] = m_activeCells.last();
+            m_activeCells.removeLast();
+        } else {
+            ++i;
+        }
+    }
+
+    if (m_activeCells.isEmpty()) {
+        m_frameTimer.stop();
+    }
+
+    if (!m_changedCells.isEmpty()) {
+        emit cellsChanged(m_changedCells);
+    }
+}
\ No newline at end of file
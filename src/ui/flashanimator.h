@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief 涨跌闪烁动画类
+ *
+ * 每个单元格的闪烁状态只占一个字节（符号表示方向，绝对值表示剩余帧数），
+ * 所有正在闪烁的单元格在同一次定时器回调中统一推进，
+ * 同时闪烁的单元格数量有上限，保证每帧的开销固定
+ */
+class FlashAnimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FlashAnimator(QObject *parent = nullptr);
+    ~FlashAnimator();
+
+    /**
+     * @brief 设置单元格数量，并清除所有闪烁状态
+     * @param count 单元格数量
+     */
+    void resize(int count);
+
+    /**
+     * @brief 触发闪烁
+     * @param cell 单元格编号
+     * @param direction 方向，大于0为上涨，小于0为下跌
+     */
+    void trigger(int cell, int direction);
+
+    /**
+     * @brief 获取闪烁强度
+     * @param cell 单元格编号
+     * @return 取值范围[-1, 1]，正数为上涨，负数为下跌，0表示未闪烁
+     */
+    qreal intensity(int cell) const;
+
+    /**
+     * @brief 设置同时闪烁的单元格上限
+     * @param count 上限
+     */
+    void setMaxActiveCells(int count);
+
+    /**
+     * @brief 当前正在闪烁的单元格数量
+     */
+    int activeCount() const { return m_activeCells.size(); }
+
+    /**
+     * @brief 因超过上限而被丢弃的闪烁次数
+     */
+    quint64 droppedCount() const { return m_droppedCount; }
+
+signals:
+    /**
+     * @brief 单元格闪烁状态变化信号，接收方只需重绘这些单元格
+     * @param cells 状态变化的单元格编号
+     */
+    void cellsChanged(const QVector<int>& cells);
+
+private slots:
+    /**
+     * @brief 推进所有闪烁动画一帧
+     */
+    void onFrameTimer();
+
+private:
+    QVector<qint8> m_levels;       // 每个单元格的闪烁状态
+    QVector<int> m_activeCells;    // 正在闪烁的单元格
+    QVector<int> m_changedCells;   // 本帧状态变化的单元格（复用缓冲区）
+    QTimer m_frameTimer;           // 动画定时器
+    int m_maxActiveCells;          // 同时闪烁的单元格上限
+    quint64 m_droppedCount;        // 被丢弃的闪烁次数
+
+    static const int kFadeFrames = 10;      // 闪烁持续帧数
+    static const int kFrameInterval = 50;   // 动画帧间隔（毫秒）
+};
\ No newline at end of file
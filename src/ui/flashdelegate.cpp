@@ -0,0 +1,33 @@
+#include "flashdelegate.h"
+#include <QAbstractProxyModel>
+
+FlashDelegate::FlashDelegate(const FlashAnimator *animator, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_animator(animator)
+{
+}
+
+FlashDelegate::~FlashDelegate()
+{
+}
+
+void FlashDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex& index) const
+{
+    QStyledItemDelegate::initStyleOption(option, index);
+
+    // 闪烁状态按源模型行号存放
+    QModelIndex sourceIndex = index;
+    while (const QAbstractProxyModel *proxy = qobject_cast<const QAbstractProxyModel*>(sourceIndex.model())) {
+        sourceIndex = proxy->mapToSource(sourceIndex);
+    }
+
+    qreal intensity = m_animator->intensity(sourceIndex.row());
+    if (intensity == 0.0) {
+        return;
+    }
+
+    // 红色表示上涨，绿色表示下跌，透明度随剩余帧数递减
+    QColor color = intensity > 0 ? QColor(255, 0, 0) : QColor(0, 128, 0);
+    color.setAlphaF(qAbs(intensity) * 0.35);
+    option->backgroundBrush = QBrush(color);
+}
\ No newline at end of file
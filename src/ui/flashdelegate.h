@@ -0,0 +1,27 @@
+#pragma once
+
+#include "flashanimator.h"
+#include <QStyledItemDelegate>
+
+/**
+ * @brief 涨跌闪烁委托类
+ *
+ * 按闪烁强度为单元格绘制渐隐的红/绿背景，单元格编号为源模型中的行号
+ */
+class FlashDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit FlashDelegate(const FlashAnimator *animator, QObject *parent = nullptr);
+    ~FlashDelegate();
+
+protected:
+    /**
+     * @brief 根据闪烁强度设置背景
+     */
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex& index) const override;
+
+private:
+    const FlashAnimator *m_animator;   // 闪烁动画
+};
\ No newline at end of file
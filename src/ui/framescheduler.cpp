@@ -0,0 +1,102 @@
+#include "framescheduler.h"
+#include <QGuiApplication>
+#include <QScreen>
+
+FrameScheduler::FrameScheduler(QObject *parent)
+    : QObject(parent)
+    , m_lastFrameTime(0)
+    , m_dirtyRegions(NoRegion)
+    , m_maxFrameRate(0)
+    , m_paused(false)
+    , m_renderedFrames(0)
+    , m_skippedFrames(0)
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &FrameScheduler::onFrameTimer);
+
+    m_clock.start();
+    m_lastFrameTime = -frameInterval();
+}
+
+FrameScheduler::~FrameScheduler()
+{
+}
+
+void FrameScheduler::markDirty(Regions regions)
+{
+    // 已有待绘制的帧，本次更新会合并进去
+    if (m_dirtyRegions != NoRegion) {
+        m_skippedFrames++;
+    }
+
+    m_dirtyRegions |= regions;
+    scheduleFrame();
+}
+
+void FrameScheduler::setMaxFrameRate(int fps)
+{
+    m_maxFrameRate = qMax(0, fps);
+}
+
+void FrameScheduler::setPaused(bool paused)
+{
+    if (m_paused == paused) {
+        return;
+    }
+
+    m_paused = paused;
+
+    if (m_paused) {
+        m_frameTimer.stop();
+    } else {
+        // 恢复时补绘暂停期间积累的脏区域
+        scheduleFrame();
+    }
+}
+
+void FrameScheduler::onFrameTimer()
+{
+    if (m_paused || m_dirtyRegions == NoRegion) {
+        return;
+    }
+
+    Regions regions = m_dirtyRegions;
+    m_dirtyRegions = NoRegion;
+    m_lastFrameTime = m_clock.elapsed();
+    m_renderedFrames++;
+
+    emit frameRequested(regions);
+}
+
+void FrameScheduler::scheduleFrame()
+{
+    if (m_paused || m_dirtyRegions == NoRegion || m_frameTimer.isActive()) {
+        return;
+    }
+
+    // 距离上一帧不足一个帧间隔时延迟到下一帧
+    qint64 elapsed = m_clock.elapsed() - m_lastFrameTime;
+    int delay = int(qMax<qint64>(0, frameInterval() - elapsed));
+    m_frameTimer.start(delay);
+}
+
+int FrameScheduler::frameInterval() const
+{
+    // 默认按60Hz显示器计算
+    qreal refreshRate = 60.0;
+    if (QScreen *screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 0) {
+            refreshRate = screen->refreshRate();
+        }
+    }
+
+    int interval = qRound(1000.0 / refreshRate);
+
+    // 设置了帧率上限时取两者中较长的间隔
+    if (m_maxFrameRate > 0) {
+        interval = qMax(interval, qRound(1000.0 / m_maxFrameRate));
+    }
+
+    return interval;
+}
\ No newline at end of file
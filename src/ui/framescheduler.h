@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * @brief 界面帧调度器
+ *
+ * 数据更新只把对应区域标记为脏，调度器按显示器刷新率（或设置的上限）
+ * 合并成一帧统一重绘，窗口最小化或被遮挡时暂停重绘
+ */
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 可重绘区域
+     */
+    enum Region {
+        NoRegion = 0x0,
+        TableRegion = 0x1,     // 股票表格
+        ChartRegion = 0x2,     // 行情图表
+        StatusRegion = 0x4     // 状态栏
+    };
+    Q_DECLARE_FLAGS(Regions, Region)
+
+public:
+    explicit FrameScheduler(QObject *parent = nullptr);
+    ~FrameScheduler();
+
+    /**
+     * @brief 标记区域需要重绘
+     * @param regions 区域
+     */
+    void markDirty(Regions regions);
+
+    /**
+     * @brief 设置最大帧率
+     * @param fps 每秒最多重绘次数，0表示跟随显示器刷新率
+     */
+    void setMaxFrameRate(int fps);
+
+    /**
+     * @brief 获取最大帧率
+     */
+    int maxFrameRate() const { return m_maxFrameRate; }
+
+    /**
+     * @brief 暂停或恢复重绘
+     * @param paused 是否暂停
+     */
+    void setPaused(bool paused);
+
+    /**
+     * @brief 是否已暂停
+     */
+    bool isPaused() const { return m_paused; }
+
+    /**
+     * @brief 已重绘的帧数
+     */
+    quint64 renderedFrames() const { return m_renderedFrames; }
+
+    /**
+     * @brief 被合并而未单独重绘的更新次数
+     */
+    quint64 skippedFrames() const { return m_skippedFrames; }
+
+signals:
+    /**
+     * @brief 帧到达信号，接收方应重绘给出的脏区域
+     * @param regions 脏区域
+     */
+    void frameRequested(FrameScheduler::Regions regions);
+
+private slots:
+    /**
+     * @brief 帧定时器触发
+     */
+    void onFrameTimer();
+
+private:
+    /**
+     * @brief 安排下一帧
+     */
+    void scheduleFrame();
+
+    /**
+     * @brief 计算帧间隔
+     * @return 帧间隔（毫秒）
+     */
+    int frameInterval() const;
+
+private:
+    QTimer m_frameTimer;         // 帧定时器
+    QElapsedTimer m_clock;       // 计时器
+    qint64 m_lastFrameTime;      // 上一帧时间（毫秒）
+    Regions m_dirtyRegions;      // 待重绘区域
+    int m_maxFrameRate;          // 最大帧率（0表示跟随显示器）
+    bool m_paused;               // 是否暂停
+
+    // 统计
+    quint64 m_renderedFrames;    // 已重绘帧数
+    quint64 m_skippedFrames;     // 被合并的更新次数
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FrameScheduler::Regions)
\ No newline at end of file
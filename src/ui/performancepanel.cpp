@@ -0,0 +1,108 @@
+#include "performancepanel.h"
+
+PerformancePanel::PerformancePanel(QWidget *parent)
+    : QLabel(parent)
+    , m_hasPrevious(false)
+{
+    setText(tr("性能采样中..."));
+    m_legend = tr("行情：每秒收到和被合并（未单独绘制）的推送\n"
+                  "解析、表格、图表：期间每次的平均耗时\n"
+                  "队列：待投递的订阅变化/待重绘的图表\n"
+                  "内存：各子系统按容器容量估算的字节数和进程常驻内存");
+    setToolTip(m_legend);
+    connect(&m_sampleTimer, &QTimer::timeout, this, &PerformancePanel::onSampleTimer);
+}
+
+PerformancePanel::~PerformancePanel()
+{
+}
+
+void PerformancePanel::setSampler(Sampler sampler)
+{
+    m_sampler = std::move(sampler);
+    m_hasPrevious = false;
+}
+
+void PerformancePanel::showEvent(QShowEvent *event)
+{
+    QLabel::showEvent(event);
+
+    // 重新显示时从头计算速率
+    m_hasPrevious = false;
+    onSampleTimer();
+    m_sampleTimer.start(1000);
+}
+
+void PerformancePanel::hideEvent(QHideEvent *event)
+{
+    QLabel::hideEvent(event);
+    m_sampleTimer.stop();
+}
+
+void PerformancePanel::onSampleTimer()
+{
+    if (!m_sampler) {
+        return;
+    }
+
+    PerformanceSample sample = m_sampler();
+    double seconds = m_clock.isValid() ? m_clock.restart() / 1000.0 : 0.0;
+    if (!m_clock.isValid()) {
+        m_clock.start();
+    }
+
+    if (m_hasPrevious && seconds > 0.0) {
+        quint64 received = sample.updatesReceived - m_previous.updatesReceived;
+        quint64 rendered = sample.updatesRendered - m_previous.updatesRendered;
+        quint64 conflated = received > rendered ? received - rendered : 0;
+
+        QString memoryText;
+        QString memoryDetails;
+        for (int i = 0; i < MemoryAccounting::TagCount; ++i) {
+            const MemoryAccounting::Usage& usage = sample.memory[i];
+            QString name = MemoryAccounting::tagName(MemoryAccounting::Tag(i));
+            memoryText += QString(" %1 %2").arg(name, megabytesText(usage.bytes));
+            memoryDetails += tr("\n%1：当前 %2，峰值 %3，%4块，累计分配%5次，本期%6次")
+                             .arg(name)
+                             .arg(megabytesText(usage.bytes))
+                             .arg(megabytesText(usage.peakBytes))
+                             .arg(usage.blocks)
+                             .arg(usage.allocations)
+                             .arg(usage.allocations - m_previous.memory[i].allocations);
+        }
+
+        setText(tr("行情 %1/s 合并 %2/s | 解析 %3 | 表格 %4 图表 %5 | 队列 %6/%7 | 内存%8 进程 %9")
+                .arg(received / seconds, 0, 'f', 1)
+                .arg(conflated / seconds, 0, 'f', 1)
+                .arg(averageText(sample.parseMicros - m_previous.parseMicros,
+                                 sample.parseCount - m_previous.parseCount))
+                .arg(averageText(sample.tableMicros - m_previous.tableMicros,
+                                 sample.tableFrames - m_previous.tableFrames))
+                .arg(averageText(sample.chartMicros - m_previous.chartMicros,
+                                 sample.chartFrames - m_previous.chartFrames))
+                .arg(sample.pendingDeliveries)
+                .arg(sample.dirtyCharts)
+                .arg(memoryText)
+                .arg(megabytesText(sample.residentBytes)));
+        setToolTip(m_legend + memoryDetails);
+    }
+
+    m_previous = sample;
+    m_hasPrevious = true;
+}
+
+QString PerformancePanel::averageText(qint64 micros, quint64 count)
+{
+    if (count == 0) {
+        return "-";
+    }
+    return QString("%1ms").arg(micros / 1000.0 / count, 0, 'f', 2);
+}
+
+QString PerformancePanel::megabytesText(qint64 bytes)
+{
+    if (bytes <= 0) {
+        return "-";
+    }
+    return QString("%1MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../data/memoryaccounting.h"
+#include <QLabel>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief 一次性能采样
+ *
+ * 计数均为累计值，面板用相邻两次采样之差计算每秒速率和期间平均耗时
+ */
+struct PerformanceSample {
+    quint64 updatesReceived = 0;    // 收到的行情推送
+    quint64 updatesRendered = 0;    // 绘制到界面的行情推送（其余被合并）
+    quint64 parseCount = 0;         // 解析次数
+    qint64 parseMicros = 0;         // 解析耗时（微秒）
+    quint64 tableFrames = 0;        // 表格帧数
+    qint64 tableMicros = 0;         // 表格帧耗时（微秒）
+    quint64 chartFrames = 0;        // 图表帧数
+    qint64 chartMicros = 0;         // 图表帧耗时（微秒）
+    int pendingDeliveries = 0;      // 等待投递给订阅者的变化
+    int dirtyCharts = 0;            // 等待下一帧重绘的图表
+    MemoryAccounting::Usage memory[MemoryAccounting::TagCount];  // 各子系统的内存统计
+    qint64 residentBytes = 0;       // 进程常驻内存，平台不支持时为0
+};
+
+/**
+ * @brief 状态栏中的性能面板
+ *
+ * 可见时每秒采样一次，显示每秒收到和被合并的行情、解析与表格/图表帧的平均耗时、
+ * 队列深度和各子系统内存（悬停显示峰值和分配次数）；隐藏时停止采样，不产生任何开销
+ */
+class PerformancePanel : public QLabel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 采样函数，返回各计数器的当前值
+     */
+    using Sampler = std::function<PerformanceSample()>;
+
+    explicit PerformancePanel(QWidget *parent = nullptr);
+    ~PerformancePanel();
+
+    /**
+     * @brief 设置采样函数
+     * @param sampler 采样函数
+     */
+    void setSampler(Sampler sampler);
+
+protected:
+    /**
+     * @brief 显示时开始采样
+     */
+    void showEvent(QShowEvent *event) override;
+
+    /**
+     * @brief 隐藏时停止采样
+     */
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    /**
+     * @brief 采样并刷新显示
+     */
+    void onSampleTimer();
+
+private:
+    /**
+     * @brief 期间平均耗时的显示文本（毫秒）
+     */
+    static QString averageText(qint64 micros, quint64 count);
+
+    /**
+     * @brief 字节数的显示文本（MB）
+     */
+    static QString megabytesText(qint64 bytes);
+
+private:
+    Sampler m_sampler;               // 采样函数
+    QTimer m_sampleTimer;            // 采样定时器
+    QElapsedTimer m_clock;           // 两次采样的间隔
+    PerformanceSample m_previous;    // 上一次采样
+    bool m_hasPrevious;              // 是否已有上一次采样
+    QString m_legend;                // 提示中的说明文字
+};
\ No newline at end of file
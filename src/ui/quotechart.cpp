@@ -1,26 +1,117 @@
 #include "quotechart.h"
+#include "../data/tracer.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QGridLayout>
 #include <QSpacerItem>
+#include <QMouseEvent>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief 时间轴位置所在的降采样列
+ * @param position 时间轴位置
+ * @param columns 列数
+ * @param positions 时间轴的位置总数
+ */
+int decimationColumn(int position, int columns, int positions)
+{
+    return int(qint64(position) * columns / positions);
+}
+
+/**
+ * @brief 成交量柱的数量：未降采样时每个交易分钟一根，降采样时与价格线同列
+ * @param decimationColumns 降采样列数，0表示未降采样
+ * @param positions 时间轴的位置总数
+ */
+int volumeBarCount(int decimationColumns, int positions)
+{
+    return decimationColumns > 0 ? decimationColumns : positions;
+}
+
+/**
+ * @brief 把[begin, end)内价格最低和最高的点按时间先后追加到价格线和均价线，不在交易时段内的点跳过
+ */
+void appendColumnPoints(const QVector<TimeSeriesPoint>& data, const SessionAxis& axis, int begin, int end,
+                        QList<QPointF> *pricePoints, QList<QPointF> *averagePoints)
+{
+    int minIndex = -1;
+    int maxIndex = -1;
+    for (int i = begin; i < end; ++i) {
+        if (axis.position(data[i].timestamp) < 0) {
+            continue;
+        }
+        if (minIndex < 0 || data[i].price < data[minIndex].price) {
+            minIndex = i;
+        }
+        if (maxIndex < 0 || data[i].price > data[maxIndex].price) {
+            maxIndex = i;
+        }
+    }
+    if (minIndex < 0) {
+        return;
+    }
+    
+    // 按时间先后输出，保证折线走向正确；均价线沿用价格线的下标
+    int first = qMin(minIndex, maxIndex);
+    int last = qMax(minIndex, maxIndex);
+    for (int index : {first, last}) {
+        int position = axis.position(data[index].timestamp);
+        pricePoints->append(QPointF(position, data[index].price));
+        averagePoints->append(QPointF(position, data[index].averagePrice));
+        if (first == last) {
+            break;
+        }
+    }
+}
+
+} // namespace
 
 QuoteChart::QuoteChart(QWidget *parent)
     : QWidget(parent)
     , m_chartView(nullptr)
     , m_chart(nullptr)
     , m_priceSeries(nullptr)
+    , m_averageSeries(nullptr)
+    , m_limitUpSeries(nullptr)
+    , m_limitDownSeries(nullptr)
     , m_volumeSeries(nullptr)
-    , m_candleSeries(nullptr)
-    , m_candleVolumeSeries(nullptr)
+    , m_volumeSet(nullptr)
+    , m_decimationColumns(0)
+    , m_lastColumnBegin(0)
+    , m_lastColumnPoints(0)
+    , m_previousClose(0.0)
+    , m_limitUp(0.0)
+    , m_limitDown(0.0)
+    , m_intradayHistoryPoints(0)
+    , m_intradayDays(1)
+    , m_renderedIntradayDays(1)
+    , m_intradayHistory(nullptr)
+    , m_intradayHistoryPending(false)
+    , m_crosshairVLine(nullptr)
+    , m_crosshairHLine(nullptr)
+    , m_crosshairText(nullptr)
+    , m_crosshairVisible(false)
+    , m_candlestickView(nullptr)
+    , m_chartStack(nullptr)
     , m_timeAxis(nullptr)
     , m_priceAxis(nullptr)
     , m_volumeAxis(nullptr)
+    , m_volumeBarAxis(nullptr)
     , m_periodComboBox(nullptr)
+    , m_daysComboBox(nullptr)
     , m_timeSeriesButton(nullptr)
     , m_candlestickButton(nullptr)
     , m_infoLabel(nullptr)
     , m_chartType(ChartType::TimeSeries)
     , m_periodType(PeriodType::Day)
+    , m_renderedChartType(ChartType::TimeSeries)
+    , m_renderedPeriodType(PeriodType::Day)
+    , m_kLineHistory(nullptr)
+    , m_historyBars(0)
+    , m_historyExhausted(false)
     , m_loadingLabel(nullptr)
 {
     setupUI();
@@ -33,6 +124,7 @@ QuoteChart::~QuoteChart()
 
 void QuoteChart::updateChart(const StockItem& stock)
 {
+    TRACE_SCOPE("QuoteChart::updateChart");
     m_currentStockCode = stock.getCode();
     
     // 更新股票信息标签
@@ -54,13 +146,27 @@ void QuoteChart::updateChart(const StockItem& stock)
     
     m_infoLabel->setText(infoText);
     
-    // 根据当前图表类型更新图表
+    // 分时图价格轴以昨收为中心，涨跌停价按板块计算
+    m_previousClose = stock.getPreviousClose();
+    m_limitUp = stock.getLimitUpPrice();
+    m_limitDown = stock.getLimitDownPrice();
+    
+    // 根据当前图表类型更新图表，同一股票优先只更新最后一个点或追加一个点
     switch (m_chartType) {
+    // 切换股票或周期时先尝试从缓存恢复，都不行才完整重建
     case ChartType::TimeSeries:
-        createTimeSeriesChart(stock);
+        if (!updateTimeSeriesChart(stock) && !restoreChart(stock)) {
+            createTimeSeriesChart(stock);
+        }
+        // 鼠标停在图上时读数随行情刷新
+        if (m_crosshairVisible) {
+            updateTimeSeriesCrosshair(m_crosshairPos);
+        }
         break;
     case ChartType::Candlestick:
-        createCandlestickChart(stock);
+        if (!updateCandlestickChart(stock) && !restoreChart(stock)) {
+            createCandlestickChart(stock);
+        }
         break;
     }
 }
@@ -79,9 +185,7 @@ void QuoteChart::setChartType(ChartType type)
             // 清除当前图表
             clearChart();
             
-            // 重新创建图表（这里需要获取最新的股票数据）
-            // 在实际应用中，应该通过数据管理器获取股票数据
-            // 此处简化处理，通过信号通知需要更新
+            // 通知主窗口取最新行情重绘；最近看过的图表数据由m_renderCache复用，不必重新计算
             emit stockChanged(m_currentStockCode);
         }
     }
@@ -130,6 +234,29 @@ void QuoteChart::onPeriodChanged(int index)
     }
 }
 
+void QuoteChart::setIntradayDays(int days)
+{
+    days = qBound(1, days, 10);
+    if (m_intradayDays != days) {
+        m_intradayDays = days;
+        
+        int index = m_daysComboBox->findData(days);
+        if (index >= 0 && index != m_daysComboBox->currentIndex()) {
+            m_daysComboBox->setCurrentIndex(index);
+        }
+        
+        // 如果是分时图且有当前股票，则更新图表
+        if (m_chartType == ChartType::TimeSeries && !m_currentStockCode.isEmpty()) {
+            emit stockChanged(m_currentStockCode);
+        }
+    }
+}
+
+void QuoteChart::onIntradayDaysChanged(int index)
+{
+    setIntradayDays(m_daysComboBox->itemData(index).toInt());
+}
+
 void QuoteChart::onTimeSeriesButtonClicked()
 {
     setChartType(ChartType::TimeSeries);
@@ -170,6 +297,13 @@ void QuoteChart::setupUI()
     m_periodComboBox->addItem(tr("30分钟"));
     m_periodComboBox->addItem(tr("60分钟"));
     
+    // 添加分时天数下拉框
+    QLabel *daysLabel = new QLabel(tr("分时:"));
+    m_daysComboBox = new QComboBox();
+    for (int days : {1, 2, 3, 5, 10}) {
+        m_daysComboBox->addItem(days == 1 ? tr("当日") : tr("%1日").arg(days), days);
+    }
+    
     // 添加股票信息标签
     m_infoLabel = new QLabel();
     QFont font = m_infoLabel->font();
@@ -177,110 +311,373 @@ void QuoteChart::setupUI()
     font.setPointSize(11);
     m_infoLabel->setFont(font);
     
+    // 历史数据加载提示，加载期间显示
+    m_loadingLabel = new QLabel(tr("加载中..."));
+    m_loadingLabel->hide();
+    
     // 添加控件到控制布局
     controlLayout->addWidget(m_timeSeriesButton);
     controlLayout->addWidget(m_candlestickButton);
     controlLayout->addSpacing(10);
     controlLayout->addWidget(periodLabel);
     controlLayout->addWidget(m_periodComboBox);
+    controlLayout->addSpacing(10);
+    controlLayout->addWidget(daysLabel);
+    controlLayout->addWidget(m_daysComboBox);
     controlLayout->addStretch();
+    controlLayout->addWidget(m_loadingLabel);
     controlLayout->addWidget(m_infoLabel);
     
     // 创建图表视图
     m_chart = new QChart();
-    m_chart->setAnimationOptions(QChart::SeriesAnimations);
+    // 每次行情更新都会改动数据，关闭动画避免逐点插值重绘
+    m_chart->setAnimationOptions(QChart::NoAnimation);
     m_chart->legend()->hide();
     
     m_chartView = new QChartView(m_chart);
     m_chartView->setRenderHint(QPainter::Antialiasing);
+    m_chartView->viewport()->setMouseTracking(true);
+    m_chartView->viewport()->installEventFilter(this);
+    
+    // 十字光标作为图表的子图元，移动时只重绘经过的区域
+    QPen crosshairPen(QColor(96, 96, 96), 1, Qt::DashLine);
+    m_crosshairVLine = new QGraphicsLineItem(m_chart);
+    m_crosshairVLine->setPen(crosshairPen);
+    m_crosshairHLine = new QGraphicsLineItem(m_chart);
+    m_crosshairHLine->setPen(crosshairPen);
+    m_crosshairText = new QGraphicsSimpleTextItem(m_chart);
+    for (QGraphicsItem *item : {static_cast<QGraphicsItem*>(m_crosshairVLine),
+                                static_cast<QGraphicsItem*>(m_crosshairHLine),
+                                static_cast<QGraphicsItem*>(m_crosshairText)}) {
+        item->setZValue(100);
+        item->hide();
+    }
+    
+    // 创建K线图视图
+    m_candlestickView = new CandlestickView();
+    m_candlestickView->setMovingAverages({5, 10, 20});
+    
+    // 分时图和K线图共用一个区域
+    m_chartStack = new QStackedWidget();
+    m_chartStack->addWidget(m_chartView);
+    m_chartStack->addWidget(m_candlestickView);
     
     // 添加组件到主布局
     mainLayout->addWidget(controlPanel);
-    mainLayout->addWidget(m_chartView);
+    mainLayout->addWidget(m_chartStack);
     
     // 连接信号
     connect(m_timeSeriesButton, &QPushButton::clicked, this, &QuoteChart::onTimeSeriesButtonClicked);
     connect(m_candlestickButton, &QPushButton::clicked, this, &QuoteChart::onCandlestickButtonClicked);
     connect(m_periodComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &QuoteChart::onPeriodChanged);
+    connect(m_daysComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &QuoteChart::onIntradayDaysChanged);
+    connect(m_candlestickView, &CandlestickView::viewportChanged, this, &QuoteChart::onCandlestickViewportChanged);
 }
 
-void QuoteChart::createTimeSeriesChart(const StockItem& stock)
+bool QuoteChart::eventFilter(QObject *watched, QEvent *event)
 {
-    clearChart();
+    if (m_chartView && watched == m_chartView->viewport()) {
+        if (event->type() == QEvent::MouseMove) {
+            updateTimeSeriesCrosshair(static_cast<QMouseEvent*>(event)->pos());
+        } else if (event->type() == QEvent::Leave) {
+            hideTimeSeriesCrosshair();
+        }
+    }
+    
+    return QWidget::eventFilter(watched, event);
+}
+
+void QuoteChart::updateTimeSeriesCrosshair(const QPoint& pos)
+{
+    m_crosshairPos = pos;
+    
+    QPointF chartPos = m_chart->mapFromScene(m_chartView->mapToScene(pos));
+    QRectF plotArea = m_chart->plotArea();
+    if (!m_priceSeries || m_timeSeriesData.isEmpty() || !plotArea.contains(chartPos)) {
+        hideTimeSeriesCrosshair();
+        return;
+    }
+    
+    // 横坐标就是时间轴位置，查表得到数据下标，与分时点数无关
+    QPointF value = m_chart->mapToValue(chartPos, m_priceSeries);
+    int index = timeSeriesIndexAt(qRound(value.x()));
+    if (index < 0) {
+        hideTimeSeriesCrosshair();
+        return;
+    }
+    
+    // 光标吸附到该时刻的价格点
+    const TimeSeriesPoint& point = m_timeSeriesData[index];
+    QPointF anchor = m_chart->mapToPosition(QPointF(m_sessionAxis.position(point.timestamp), point.price), m_priceSeries);
+    m_crosshairVLine->setLine(anchor.x(), plotArea.top(), anchor.x(), plotArea.bottom());
+    m_crosshairHLine->setLine(plotArea.left(), anchor.y(), plotArea.right(), anchor.y());
+    
+    double change = m_previousClose > 0 ? (point.price - m_previousClose) / m_previousClose * 100.0 : 0.0;
+    m_crosshairText->setText(tr("%1  价 %2  %3%4%  均价 %5  量 %6")
+                             .arg(point.timestamp.toString(m_sessionAxis.dayCount() > 1 ? "MM-dd hh:mm" : "hh:mm"))
+                             .arg(point.price, 0, 'f', 2)
+                             .arg(change > 0 ? "+" : "")
+                             .arg(change, 0, 'f', 2)
+                             .arg(point.averagePrice, 0, 'f', 2)
+                             .arg(point.volume));
+    m_crosshairText->setBrush(change > 0 ? QColor(255, 0, 0) : change < 0 ? QColor(0, 128, 0) : QColor(0, 0, 0));
+    m_crosshairText->setPos(plotArea.left() + 4, plotArea.top() + 2);
+    
+    m_crosshairVLine->show();
+    m_crosshairHLine->show();
+    m_crosshairText->show();
+    m_crosshairVisible = true;
+}
+
+void QuoteChart::hideTimeSeriesCrosshair()
+{
+    m_crosshairVLine->hide();
+    m_crosshairHLine->hide();
+    m_crosshairText->hide();
+    m_crosshairVisible = false;
+}
+
+int QuoteChart::timeSeriesIndexAt(int position) const
+{
+    if (position < 0 || position >= m_positionIndex.size()) {
+        return -1;
+    }
+    return m_positionIndex[position];
+}
+
+void QuoteChart::buildPositionIndex()
+{
+    m_positionIndex.fill(-1, m_sessionAxis.size());
     
-    // 获取分时数据
-    const QVector<TimeSeriesPoint>& timeSeriesData = stock.getTimeSeriesData();
+    int lastPosition = -1;
+    for (int i = 0; i < m_timeSeriesData.size(); ++i) {
+        int position = m_sessionAxis.position(m_timeSeriesData[i].timestamp);
+        if (position >= 0) {
+            m_positionIndex[position] = i;
+            lastPosition = qMax(lastPosition, position);
+        }
+    }
     
-    if (timeSeriesData.isEmpty()) {
+    // 缺失的分钟沿用前一个点，最新数据之后保持-1
+    int current = -1;
+    for (int position = 0; position < lastPosition; ++position) {
+        if (m_positionIndex[position] >= 0) {
+            current = m_positionIndex[position];
+        } else {
+            m_positionIndex[position] = current;
+        }
+    }
+}
+
+void QuoteChart::createTimeSeriesChart(const StockItem& stock)
+{
+    TRACE_SCOPE("QuoteChart::createTimeSeriesChart");
+    // 获取分时数据（完整重建时取一份完整副本）
+    const QVector<TimeSeriesPoint> todayData = stock.getTimeSeriesData();
+    
+    if (todayData.isEmpty()) {
+        clearChart();
+        m_chartStack->setCurrentWidget(m_chartView);
         m_chart->setTitle(tr("无分时数据"));
         return;
     }
     
-    // 创建价格线系列
-    m_priceSeries = new QLineSeries();
-    m_priceSeries->setName(tr("价格"));
+    ChartRenderData data;
+    QString name = m_intradayDays > 1 ? tr("%1 %2日分时").arg(stock.getName()).arg(m_intradayDays)
+                                       : tr("%1 分时图").arg(stock.getName());
+    data.title = tr("%1  涨停 %2  跌停 %3")
+                     .arg(name)
+                     .arg(m_limitUp, 0, 'f', 2)
+                     .arg(m_limitDown, 0, 'f', 2);
     
-    // 创建成交量柱状图系列
-    m_volumeSeries = new QBarSeries();
-    QBarSet *volumeSet = new QBarSet(tr("成交量"));
+    // 往日分时按交易日从历史缓存加载，没有数据的日期（如停牌）跳过；
+    // 正在加载的日期先占一天，加载完成后由onIntradayDayLoaded重建
+    data.sessionDays.append(todayData.first().timestamp.toTimeZone(TradingCalendar::timeZone()).date());
+    QVector<QVector<TimeSeriesPoint>> history;
+    QDate date = data.sessionDays.first();
+    int pendingDays = 0;
+    for (int attempt = 0; m_intradayHistory && data.sessionDays.size() + pendingDays < m_intradayDays && attempt < m_intradayDays * 2; ++attempt) {
+        date = m_intradayHistory->tradingCalendar()->previousTradingDay(date);
+        QVector<TimeSeriesPoint> points;
+        if (!m_intradayHistory->day(stock.getCode(), date, &points)) {
+            ++pendingDays;
+        } else if (!points.isEmpty()) {
+            data.sessionDays.prepend(date);
+            history.prepend(points);
+        }
+    }
     
-    // 设置图表标题
-    m_chart->setTitle(tr("%1 分时图").arg(stock.getName()));
+    for (const QVector<TimeSeriesPoint>& points : history) {
+        data.timeSeries += points;
+    }
+    data.intradayHistoryPoints = data.timeSeries.size();
+    data.timeSeries += todayData;
     
     // 填充数据
-    QDateTime minTime = timeSeriesData.first().timestamp;
-    QDateTime maxTime = timeSeriesData.last().timestamp;
-    
-    double minPrice = stock.getLowPrice() * 0.98; // 留一些边距
-    double maxPrice = stock.getHighPrice() * 1.02;
+    const QVector<TimeSeriesPoint>& timeSeriesData = data.timeSeries;
+    SessionAxis axis;
+    axis.setDays(data.sessionDays);
     
-    long long maxVolume = 0;
+    QVector<int> positions;
+    positions.reserve(timeSeriesData.size());
     
+    // 价格轴按分时价格的实际极值计算，以昨收为中心对称，极值在换算位置时一并求出
+    double lowPrice = timeSeriesData.first().price;
+    double highPrice = lowPrice;
     for (const TimeSeriesPoint& point : timeSeriesData) {
-        // 添加价格点
-        m_priceSeries->append(point.timestamp.toMSecsSinceEpoch(), point.price);
-        
-        // 添加成交量
-        *volumeSet << point.volume;
+        lowPrice = qMin(lowPrice, point.price);
+        highPrice = qMax(highPrice, point.price);
         
-        // 更新最大成交量
-        if (point.volume > maxVolume) {
-            maxVolume = point.volume;
+        // 横坐标为交易时段压缩后的位置，查表换算
+        positions.append(axis.position(point.timestamp));
+    }
+    symmetricPriceRange(lowPrice, highPrice, &data.minPrice, &data.maxPrice);
+    
+    // 价格点数超过绘图区宽度两倍时按像素列降采样，只保留每列的最高点和最低点；
+    // 按时间轴位置分列，新数据只落在最后一列，增量更新时只需重算这一列
+    int columns = int(m_chart->plotArea().width());
+    if (columns > 0 && timeSeriesData.size() > columns * 2) {
+        data.decimationColumns = columns;
+    }
+    
+    // 均价线平滑，沿用价格线的下标即可；不在交易时段内的点不绘制
+    int count = timeSeriesData.size();
+    int reserved = data.decimationColumns > 0 ? columns * 2 : count;
+    data.pricePoints.reserve(reserved);
+    data.averagePoints.reserve(reserved);
+    for (int begin = 0; begin < count;) {
+        int end = begin + 1;
+        if (data.decimationColumns > 0 && positions[begin] >= 0) {
+            int column = decimationColumn(positions[begin], columns, axis.size());
+            while (end < count
+                   && (positions[end] < 0 || decimationColumn(positions[end], columns, axis.size()) == column)) {
+                ++end;
+            }
+        }
+        appendColumnPoints(timeSeriesData, axis, begin, end, &data.pricePoints, &data.averagePoints);
+        begin = end;
+    }
+    
+    // 成交量按时间轴位置归入柱子，降采样时与价格线同列合计；
+    // 缺失的分钟为空柱，不在交易时段内的点（如集合竞价）不计入
+    int bars = volumeBarCount(data.decimationColumns, axis.size());
+    data.volumes = QList<qreal>(bars, 0.0);
+    for (int i = 0; i < count; ++i) {
+        if (positions[i] >= 0) {
+            data.volumes[decimationColumn(positions[i], bars, axis.size())] += timeSeriesData[i].volume;
         }
     }
+    data.maxVolume = *std::max_element(data.volumes.cbegin(), data.volumes.cend()) * 1.1;
     
-    m_volumeSeries->append(volumeSet);
+    applyTimeSeriesData(stock.getCode(), data);
+    m_intradayHistoryPending = pendingDays > 0;
+    showLoadingState(m_intradayHistoryPending);
+}
+
+void QuoteChart::applyTimeSeriesData(const QString& code, const ChartRenderData& data)
+{
+    clearChart();
+    m_chartStack->setCurrentWidget(m_chartView);
+    
+    // 十字光标读数使用完整的分时数据
+    m_sessionAxis.setDays(data.sessionDays);
+    m_timeSeriesData = data.timeSeries;
+    m_intradayHistoryPoints = data.intradayHistoryPoints;
+    m_intradayHistoryPending = false;
+    buildPositionIndex();
+    
+    // 创建价格线系列
+    m_priceSeries = new QLineSeries();
+    m_priceSeries->setName(tr("价格"));
+    m_priceSeries->replace(data.pricePoints);
+    m_decimationColumns = data.decimationColumns;
+    locateLastColumn();
     
-    // 创建坐标轴
-    m_timeAxis = new QDateTimeAxis();
-    m_timeAxis->setFormat("hh:mm");
-    m_timeAxis->setRange(minTime, maxTime);
-    m_timeAxis->setTickCount(6);
+    // 均价线
+    m_averageSeries = new QLineSeries();
+    m_averageSeries->setName(tr("均价"));
+    m_averageSeries->setPen(QPen(QColor(255, 140, 0), 1));
+    m_averageSeries->replace(data.averagePoints);
+    
+    // 当日的涨跌停价线，超出价格轴时被裁掉，价格接近涨跌停时出现在图的上下边缘
+    int todayStart = (m_sessionAxis.dayCount() - 1) * SessionAxis::kMinutesPerDay;
+    int todayEnd = m_sessionAxis.size();
+    m_limitUpSeries = new QLineSeries();
+    m_limitUpSeries->setName(tr("涨停"));
+    m_limitUpSeries->setPen(QPen(QColor(255, 0, 0), 1, Qt::DashLine));
+    m_limitUpSeries->append(todayStart, m_limitUp);
+    m_limitUpSeries->append(todayEnd, m_limitUp);
+    m_limitDownSeries = new QLineSeries();
+    m_limitDownSeries->setName(tr("跌停"));
+    m_limitDownSeries->setPen(QPen(QColor(0, 128, 0), 1, Qt::DashLine));
+    m_limitDownSeries->append(todayStart, m_limitDown);
+    m_limitDownSeries->append(todayEnd, m_limitDown);
+    
+    // 创建成交量柱状图系列
+    m_volumeSeries = new QBarSeries();
+    m_volumeSet = new QBarSet(tr("成交量"));
+    m_volumeSet->append(data.volumes);
+    m_volumeSeries->append(m_volumeSet);
+    
+    // 柱子按下标排列，用一条隐藏的横轴把第i根柱子对齐到第i个交易分钟或第i列的中间
+    m_volumeBarAxis = new QValueAxis();
+    m_volumeBarAxis->setVisible(false);
+    if (data.decimationColumns > 0) {
+        m_volumeBarAxis->setRange(-0.5, data.volumes.size() - 0.5);
+    } else {
+        m_volumeBarAxis->setRange(0, data.volumes.size());
+    }
+    
+    // 设置图表标题
+    m_chart->setTitle(data.title);
+    
+    // 创建坐标轴：时间轴覆盖所有交易日的完整交易时段，午休和隔夜不占位置
+    m_timeAxis = new QCategoryAxis();
+    m_timeAxis->setLabelsPosition(QCategoryAxis::AxisLabelsPositionOnValue);
+    m_timeAxis->setRange(0, m_sessionAxis.size());
+    if (m_sessionAxis.dayCount() == 1) {
+        m_timeAxis->append("09:30", 0);
+        m_timeAxis->append("10:30", 60);
+        m_timeAxis->append("11:30/13:00", 120);
+        m_timeAxis->append("14:00", 180);
+        m_timeAxis->append("15:00", 240);
+    } else {
+        // 多日时在每个交易日的开始标注日期
+        for (int i = 0; i < m_sessionAxis.dayCount(); ++i) {
+            m_timeAxis->append(m_sessionAxis.days()[i].toString("MM-dd"), i * SessionAxis::kMinutesPerDay);
+        }
+    }
     
     m_priceAxis = new QValueAxis();
-    m_priceAxis->setRange(minPrice, maxPrice);
+    m_priceAxis->setRange(data.minPrice, data.maxPrice);
     m_priceAxis->setLabelFormat("%.2f");
     m_priceAxis->setTickCount(5);
     
     m_volumeAxis = new QValueAxis();
-    m_volumeAxis->setRange(0, maxVolume * 1.1);
+    m_volumeAxis->setRange(0, data.maxVolume);
     m_volumeAxis->setLabelFormat("%d");
     m_volumeAxis->setTickCount(3);
     
     // 添加系列到图表
     m_chart->addSeries(m_priceSeries);
+    m_chart->addSeries(m_averageSeries);
+    m_chart->addSeries(m_limitUpSeries);
+    m_chart->addSeries(m_limitDownSeries);
     m_chart->addSeries(m_volumeSeries);
     
     // 添加坐标轴到图表
     m_chart->addAxis(m_timeAxis, Qt::AlignBottom);
     m_chart->addAxis(m_priceAxis, Qt::AlignLeft);
     m_chart->addAxis(m_volumeAxis, Qt::AlignRight);
+    m_chart->addAxis(m_volumeBarAxis, Qt::AlignBottom);
     
     // 关联系列到坐标轴
-    m_priceSeries->attachAxis(m_timeAxis);
-    m_priceSeries->attachAxis(m_priceAxis);
+    for (QLineSeries *series : {m_priceSeries, m_averageSeries, m_limitUpSeries, m_limitDownSeries}) {
+        series->attachAxis(m_timeAxis);
+        series->attachAxis(m_priceAxis);
+    }
     
-    m_volumeSeries->attachAxis(m_timeAxis);
+    m_volumeSeries->attachAxis(m_volumeBarAxis);
     m_volumeSeries->attachAxis(m_volumeAxis);
     
     // 设置图表布局
@@ -288,140 +685,527 @@ void QuoteChart::createTimeSeriesChart(const StockItem& stock)
     
     // 显示图表
     m_chartView->setChart(m_chart);
+    
+    m_renderedStockCode = code;
+    m_renderedChartType = ChartType::TimeSeries;
+    m_renderedIntradayDays = m_intradayDays;
 }
 
-void QuoteChart::createCandlestickChart(const StockItem& stock)
+bool QuoteChart::updateTimeSeriesChart(const StockItem& stock)
 {
-    clearChart();
+    if (!m_priceSeries || !m_volumeSet || m_renderedStockCode != stock.getCode()
+        || m_renderedIntradayDays != m_intradayDays) {
+        return false;
+    }
     
-    // 获取K线数据
-    const QVector<StockTradeData>& kLineData = stock.getKLineData();
+    // 只处理当日最后一个点变化或新增一个点的情况，前面的往日分时不变
+    int count = stock.getTimeSeriesCount();
+    int rendered = m_timeSeriesData.size() - m_intradayHistoryPoints;
+    if (rendered <= 0 || (count != rendered && count != rendered + 1)) {
+        return false;
+    }
     
-    if (kLineData.isEmpty()) {
-        m_chart->setTitle(tr("无K线数据"));
+    // 当日第一个点也必须对得上，数据被整体替换（如重新加载）后点数可能碰巧相同
+    if (stock.getTimeSeriesPoint(0).timestamp != m_timeSeriesData[m_intradayHistoryPoints].timestamp) {
+        return false;
+    }
+    
+    // 已绘制的最后一个点必须仍在原来的位置（换日后不在时间轴上，需要重建）
+    const TimeSeriesPoint& lastRendered = stock.getTimeSeriesPoint(rendered - 1);
+    int lastIndex = m_intradayHistoryPoints + rendered - 1;
+    int lastPosition = m_sessionAxis.position(lastRendered.timestamp);
+    if (lastPosition < 0 || lastRendered.timestamp != m_timeSeriesData[lastIndex].timestamp) {
+        return false;
+    }
+    
+    int position = lastPosition;
+    if (count == rendered + 1) {
+        position = m_sessionAxis.position(stock.getLastTimeSeriesPoint().timestamp);
+        if (position <= lastPosition) {
+            return false;
+        }
+    }
+    
+    // 未降采样时价格点与分时数据一一对应，直接替换或追加
+    if (m_decimationColumns == 0) {
+        m_priceSeries->replace(lastIndex, lastPosition, lastRendered.price);
+        m_averageSeries->replace(lastIndex, lastPosition, lastRendered.averagePrice);
+    }
+    addVolume(lastPosition, lastRendered.volume - m_timeSeriesData[lastIndex].volume);
+    m_timeSeriesData[lastIndex] = lastRendered;
+    extendTimeSeriesAxes(lastRendered);
+    
+    if (count == rendered + 1) {
+        const TimeSeriesPoint& point = stock.getLastTimeSeriesPoint();
+        if (m_decimationColumns == 0) {
+            m_priceSeries->append(position, point.price);
+            m_averageSeries->append(position, point.averagePrice);
+        }
+        addVolume(position, point.volume);
+        m_timeSeriesData.append(point);
+        extendTimeSeriesAxes(point);
+        
+        // 查找表：中间缺失的分钟沿用前一个点
+        for (int i = lastPosition + 1; i < position; ++i) {
+            m_positionIndex[i] = lastIndex;
+        }
+        m_positionIndex[position] = lastIndex + 1;
+    }
+    
+    // 降采样时只重算最后一列，前面的列不受影响
+    if (m_decimationColumns > 0) {
+        updateLastColumn();
+    }
+    
+    return true;
+}
+
+void QuoteChart::locateLastColumn()
+{
+    m_lastColumnBegin = m_timeSeriesData.size();
+    m_lastColumnPoints = 0;
+    if (m_decimationColumns == 0) {
         return;
     }
     
-    // 创建K线图系列
-    m_candleSeries = new QCandlestickSeries();
-    m_candleSeries->setName(tr("K线"));
-    m_candleSeries->setIncreasingColor(QColor(255, 0, 0));
-    m_candleSeries->setDecreasingColor(QColor(0, 128, 0));
+    // 最后一个在时间轴上的点所在的列
+    int last = m_timeSeriesData.size() - 1;
+    while (last >= 0 && m_sessionAxis.position(m_timeSeriesData[last].timestamp) < 0) {
+        --last;
+    }
+    if (last < 0) {
+        return;
+    }
+    int column = decimationColumn(m_sessionAxis.position(m_timeSeriesData[last].timestamp),
+                                  m_decimationColumns, m_sessionAxis.size());
     
-    // 创建成交量柱状图系列
-    m_candleVolumeSeries = new QBarSeries();
-    QBarSet *volumeSet = new QBarSet(tr("成交量"));
+    // 向前找到这一列的第一个点，中间不在时间轴上的点一并归入
+    m_lastColumnBegin = last;
+    for (int i = last - 1; i >= 0; --i) {
+        int position = m_sessionAxis.position(m_timeSeriesData[i].timestamp);
+        if (position >= 0 && decimationColumn(position, m_decimationColumns, m_sessionAxis.size()) != column) {
+            break;
+        }
+        if (position >= 0) {
+            m_lastColumnBegin = i;
+        }
+    }
     
-    // 获取周期字符串
-    QString periodStr;
-    switch (m_periodType) {
-    case PeriodType::Day:
-        periodStr = tr("日K");
-        break;
-    case PeriodType::Week:
-        periodStr = tr("周K");
-        break;
-    case PeriodType::Month:
-        periodStr = tr("月K");
-        break;
-    case PeriodType::Minutes:
-        periodStr = tr("分钟K");
-        break;
-    case PeriodType::Minutes5:
-        periodStr = tr("5分钟K");
-        break;
-    case PeriodType::Minutes15:
-        periodStr = tr("15分钟K");
-        break;
-    case PeriodType::Minutes30:
-        periodStr = tr("30分钟K");
-        break;
-    case PeriodType::Minutes60:
-        periodStr = tr("60分钟K");
-        break;
+    // 每列最多两个点
+    for (int i = m_priceSeries->count() - 1; i >= 0 && m_lastColumnPoints < 2; --i) {
+        int position = qRound(m_priceSeries->at(i).x());
+        if (decimationColumn(position, m_decimationColumns, m_sessionAxis.size()) != column) {
+            break;
+        }
+        ++m_lastColumnPoints;
+    }
+}
+
+void QuoteChart::updateLastColumn()
+{
+    // 最新的点落在新的一列时，前一列已经定型
+    int last = m_timeSeriesData.size() - 1;
+    int column = decimationColumn(m_sessionAxis.position(m_timeSeriesData[last].timestamp),
+                                  m_decimationColumns, m_sessionAxis.size());
+    if (m_lastColumnBegin > last
+        || decimationColumn(m_sessionAxis.position(m_timeSeriesData[m_lastColumnBegin].timestamp),
+                            m_decimationColumns, m_sessionAxis.size()) != column) {
+        m_lastColumnBegin = last;
+        m_lastColumnPoints = 0;
+    }
+    
+    QList<QPointF> pricePoints;
+    QList<QPointF> averagePoints;
+    appendColumnPoints(m_timeSeriesData, m_sessionAxis, m_lastColumnBegin, last + 1, &pricePoints, &averagePoints);
+    
+    // 点数不变时原地替换，否则去掉旧点后追加
+    int first = m_priceSeries->count() - m_lastColumnPoints;
+    if (pricePoints.size() == m_lastColumnPoints) {
+        for (int i = 0; i < pricePoints.size(); ++i) {
+            m_priceSeries->replace(first + i, pricePoints[i]);
+            m_averageSeries->replace(first + i, averagePoints[i]);
+        }
+    } else {
+        if (m_lastColumnPoints > 0) {
+            m_priceSeries->removePoints(first, m_lastColumnPoints);
+            m_averageSeries->removePoints(first, m_lastColumnPoints);
+        }
+        m_priceSeries->append(pricePoints);
+        m_averageSeries->append(averagePoints);
+        m_lastColumnPoints = pricePoints.size();
+    }
+}
+
+void QuoteChart::addVolume(int position, qreal volume)
+{
+    if (volume == 0) {
+        return;
     }
     
+    // 成交量柱按时间轴位置或降采样列合计，只改这一根柱子
+    int bar = decimationColumn(position, m_volumeSet->count(), m_sessionAxis.size());
+    qreal value = m_volumeSet->at(bar) + volume;
+    m_volumeSet->replace(bar, value);
+    if (value > m_volumeAxis->max()) {
+        m_volumeAxis->setMax(value * 1.1);
+    }
+}
+
+void QuoteChart::extendTimeSeriesAxes(const TimeSeriesPoint& point)
+{
+    // 时间轴固定覆盖完整交易时段，只在新数据超出当前范围时调整价格轴
+    // 两个以昨收为中心的对称范围合并后仍然对称
+    if (point.price < m_priceAxis->min() || point.price > m_priceAxis->max()) {
+        double minPrice = 0.0;
+        double maxPrice = 0.0;
+        symmetricPriceRange(point.price, point.price, &minPrice, &maxPrice);
+        m_priceAxis->setRange(qMin(minPrice, m_priceAxis->min()), qMax(maxPrice, m_priceAxis->max()));
+    }
+}
+
+void QuoteChart::symmetricPriceRange(double low, double high, double *minPrice, double *maxPrice) const
+{
+    // 没有昨收时退回按最高最低价留边距
+    if (m_previousClose <= 0) {
+        *minPrice = low * 0.98;
+        *maxPrice = high * 1.02;
+        return;
+    }
+    
+    // 取偏离昨收较大的一侧并留10%边距，至少显示±1%；只显示当日时最多到涨跌停价，
+    // 多日分时包含往日价格，不按当日涨跌停价截断
+    double amplitude = qMax(qAbs(high - m_previousClose), qAbs(low - m_previousClose)) * 1.1;
+    amplitude = qMax(amplitude, m_previousClose * 0.01);
+    if (m_intradayDays == 1 && m_limitUp > m_previousClose && m_limitDown < m_previousClose) {
+        amplitude = qMin(amplitude, qMax(m_limitUp - m_previousClose, m_previousClose - m_limitDown));
+    }
+    
+    *minPrice = m_previousClose - amplitude;
+    *maxPrice = m_previousClose + amplitude;
+}
+
+bool QuoteChart::updateCandlestickChart(const StockItem& stock)
+{
+    if (m_renderedStockCode != stock.getCode() || m_renderedPeriodType != m_periodType) {
+        return false;
+    }
+    
+    // 只处理最后一根K线变化或新增一根K线的情况
+    const QVector<StockTradeData>& kLineData = stock.getKLineData();
+    const OhlcvSeries& rendered = m_candlestickView->series();
+    int count = rendered.size() - m_historyBars;  // 前面加载的历史K线不参与比较
+    if (count == 0 || (kLineData.size() != count && kLineData.size() != count + 1)) {
+        return false;
+    }
+    
+    // 已绘制的第一根和最后一根K线必须仍在原来的位置，数据被整体替换时重建
+    if (kLineData.first().timestamp.toMSecsSinceEpoch() != rendered.time()[m_historyBars]
+        || kLineData[count - 1].timestamp.toMSecsSinceEpoch() != rendered.time().last()) {
+        return false;
+    }
+    
+    m_candlestickView->updateLastBar(kLineData[count - 1]);
+    if (kLineData.size() == count + 1) {
+        m_candlestickView->appendBar(kLineData.last());
+    }
+    
+    return true;
+}
+
+void QuoteChart::createCandlestickChart(const StockItem& stock)
+{
+    TRACE_SCOPE("QuoteChart::createCandlestickChart");
+    clearChart();
+    m_chartStack->setCurrentWidget(m_candlestickView);
+    
     // 设置图表标题
-    m_chart->setTitle(tr("%1 %2").arg(stock.getName()).arg(periodStr));
+    m_candlestickView->setTitle(tr("%1 %2").arg(stock.getName()).arg(periodName()));
     
-    // 填充数据
-    QDateTime minTime = kLineData.first().timestamp;
-    QDateTime maxTime = kLineData.last().timestamp;
+    // 设置时间轴格式
+    if (m_periodType == PeriodType::Day || m_periodType == PeriodType::Week || m_periodType == PeriodType::Month) {
+        m_candlestickView->setTimeFormat("MM-dd");
+    } else {
+        m_candlestickView->setTimeFormat("hh:mm");
+    }
     
-    double minPrice = stock.getLowPrice() * 0.98; // 留一些边距
-    double maxPrice = stock.getHighPrice() * 1.02;
+    // 重新开始加载历史，需在设置数据之前，设置数据时可见范围变化会触发加载
+    m_renderedStockCode = stock.getCode();
+    m_renderedChartType = ChartType::Candlestick;
+    m_renderedPeriodType = m_periodType;
+    m_historyChunkSizes.clear();
+    m_historyBars = 0;
+    m_historyExhausted = false;
     
-    long long maxVolume = 0;
+    // 转为列式数据后直接绘制，不为每根K线创建对象
+    m_candlestickView->setSeries(OhlcvSeries::fromKLineData(stock.getKLineData()));
+}
+
+void QuoteChart::applyCandlestickData(const QString& code, const ChartRenderData& data)
+{
+    clearChart();
+    m_chartStack->setCurrentWidget(m_candlestickView);
     
-    for (const StockTradeData& data : kLineData) {
-        // 创建K线柱
-        QCandlestickSet *candleSet = new QCandlestickSet(data.open, data.high, data.low, data.close, data.timestamp.toMSecsSinceEpoch());
-        m_candleSeries->append(candleSet);
-        
-        // 添加成交量
-        *volumeSet << data.volume;
+    m_candlestickView->setTitle(data.title);
+    m_candlestickView->setTimeFormat(data.timeFormat);
+    
+    // 恢复历史加载状态，需在设置数据之前
+    m_renderedStockCode = code;
+    m_renderedChartType = ChartType::Candlestick;
+    m_renderedPeriodType = m_periodType;
+    m_historyChunkSizes = data.historyChunkSizes;
+    m_historyBars = std::accumulate(m_historyChunkSizes.cbegin(), m_historyChunkSizes.cend(), 0);
+    m_historyExhausted = data.historyExhausted;
+    
+    m_candlestickView->setSeries(data.series, data.viewFirst, data.viewCount);
+}
+
+QString QuoteChart::cacheKey(const QString& code, ChartType chartType, PeriodType periodType, int intradayDays) const
+{
+    // 分时图与K线周期无关，以负数区分显示天数
+    int period = chartType == ChartType::TimeSeries ? -intradayDays : int(periodType);
+    return ChartDataCache::key(code, int(chartType), period);
+}
+
+void QuoteChart::stashRenderData()
+{
+    if (m_renderedStockCode.isEmpty()) {
+        return;
+    }
+    
+    ChartRenderData data;
+    
+    if (m_renderedChartType == ChartType::TimeSeries) {
+        // 往日数据还没有加载齐的图表不缓存，以免之后恢复出缺天的分时图
+        if (!m_priceSeries || !m_volumeSet || m_intradayHistoryPending) {
+            return;
+        }
         
-        // 更新最大成交量
-        if (data.volume > maxVolume) {
-            maxVolume = data.volume;
+        // 增量更新后的数据以当前系列和坐标轴为准
+        data.title = m_chart->title();
+        data.pricePoints = m_priceSeries->points();
+        data.averagePoints = m_averageSeries->points();
+        data.volumes.reserve(m_volumeSet->count());
+        for (int i = 0; i < m_volumeSet->count(); ++i) {
+            data.volumes.append(m_volumeSet->at(i));
+        }
+        data.sessionDays = m_sessionAxis.days();
+        data.timeSeries = m_timeSeriesData;
+        data.intradayHistoryPoints = m_intradayHistoryPoints;
+        data.minPrice = m_priceAxis->min();
+        data.maxPrice = m_priceAxis->max();
+        data.maxVolume = m_volumeAxis->max();
+        data.decimationColumns = m_decimationColumns;
+    } else {
+        data.title = m_candlestickView->title();
+        data.timeFormat = m_candlestickView->timeFormat();
+        data.series = m_candlestickView->series();
+        data.viewFirst = m_candlestickView->viewFirst();
+        data.viewCount = m_candlestickView->viewCount();
+        data.historyChunkSizes = m_historyChunkSizes;
+        data.historyExhausted = m_historyExhausted;
+    }
+    
+    m_renderCache.insert(cacheKey(m_renderedStockCode, m_renderedChartType, m_renderedPeriodType, m_renderedIntradayDays), data);
+}
+
+bool QuoteChart::restoreChart(const StockItem& stock)
+{
+    TRACE_SCOPE("QuoteChart::restoreChart");
+    QString key = cacheKey(stock.getCode(), m_chartType, m_periodType, m_intradayDays);
+    
+    // 当前显示的就是这份数据时无需恢复
+    if (!m_renderedStockCode.isEmpty()
+        && key == cacheKey(m_renderedStockCode, m_renderedChartType, m_renderedPeriodType, m_renderedIntradayDays)) {
+        return false;
+    }
+    
+    const ChartRenderData *cached = m_renderCache.find(key);
+    if (!cached) {
+        return false;
+    }
+    
+    // 先复制（隐式共享，开销很小），恢复过程中暂存当前图表可能淘汰该缓存项
+    ChartRenderData data = *cached;
+    
+    // 恢复后按最新行情增量更新，数据对不上时返回false由调用者完整重建
+    bool updated = false;
+    if (m_chartType == ChartType::TimeSeries) {
+        applyTimeSeriesData(stock.getCode(), data);
+        updated = updateTimeSeriesChart(stock);
+    } else {
+        applyCandlestickData(stock.getCode(), data);
+        updated = updateCandlestickChart(stock);
+    }
+    
+    // 缓存的数据已过时：丢弃，并标记当前图表未完整绘制，重建时不会再被暂存回缓存
+    if (!updated) {
+        m_renderCache.remove(key);
+        m_renderedStockCode.clear();
+    }
+    return updated;
+}
+
+void QuoteChart::setKLineHistory(KLineHistory *history)
+{
+    if (m_kLineHistory) {
+        disconnect(m_kLineHistory, nullptr, this, nullptr);
+    }
+    
+    m_kLineHistory = history;
+    if (m_kLineHistory) {
+        connect(m_kLineHistory, &KLineHistory::chunkLoaded, this, &QuoteChart::onKLineChunkLoaded);
+    }
+}
+
+void QuoteChart::setIntradayHistory(IntradayHistory *history)
+{
+    if (m_intradayHistory) {
+        disconnect(m_intradayHistory, nullptr, this, nullptr);
+    }
+    
+    m_intradayHistory = history;
+    if (m_intradayHistory) {
+        connect(m_intradayHistory, &IntradayHistory::dayLoaded, this, &QuoteChart::onIntradayDayLoaded);
+    }
+}
+
+void QuoteChart::onCandlestickViewportChanged(int firstBar, int barCount)
+{
+    if (!m_kLineHistory || m_renderedStockCode.isEmpty()) {
+        return;
+    }
+    
+    // 距离已加载数据的左边缘不足一屏时，向前加载一块历史
+    if (firstBar < barCount && !m_historyExhausted) {
+        const OhlcvSeries& series = m_candlestickView->series();
+        if (series.isEmpty()) {
+            return;
         }
         
-        // 更新价格范围
-        if (data.low < minPrice) {
-            minPrice = data.low * 0.98;
+        // 未缓存时异步加载，加载完成后由onKLineChunkLoaded继续
+        OhlcvSeries chunk;
+        if (!m_kLineHistory->chunkBefore(m_renderedStockCode, barInterval(), series.time().first(), &chunk)) {
+            showLoadingState(true);
+            return;
         }
-        if (data.high > maxPrice) {
-            maxPrice = data.high * 1.02;
+        showLoadingState(false);
+        if (chunk.isEmpty()) {
+            m_historyExhausted = true;
+            return;
         }
+        
+        m_historyChunkSizes.prepend(chunk.size());
+        m_historyBars += chunk.size();
+        m_candlestickView->prependBars(chunk);
+        return;
     }
     
-    m_candleVolumeSeries->append(volumeSet);
+    // 最早的一块离可见范围超过一屏时释放，需要时再从缓存取回
+    if (!m_historyChunkSizes.isEmpty() && firstBar - m_historyChunkSizes.first() >= barCount) {
+        int size = m_historyChunkSizes.takeFirst();
+        m_historyBars -= size;
+        m_historyExhausted = false;
+        m_candlestickView->removeFirstBars(size);
+    }
+}
+
+void QuoteChart::onKLineChunkLoaded(const QString& code, qint64 interval, qint64 endTime, bool ok)
+{
+    // 仍需加载时由onCandlestickViewportChanged重新显示提示
+    showLoadingState(false);
     
-    // 创建坐标轴
-    m_timeAxis = new QDateTimeAxis();
-    if (m_periodType == PeriodType::Day || m_periodType == PeriodType::Week || m_periodType == PeriodType::Month) {
-        m_timeAxis->setFormat("MM-dd");
-    } else {
-        m_timeAxis->setFormat("hh:mm");
+    // 失败时不立即重试，下次可见范围变化时再请求
+    if (!ok || m_renderedChartType != ChartType::Candlestick || code != m_renderedStockCode
+        || interval != barInterval()) {
+        return;
     }
-    m_timeAxis->setRange(minTime, maxTime);
-    m_timeAxis->setTickCount(6);
     
-    m_priceAxis = new QValueAxis();
-    m_priceAxis->setRange(minPrice, maxPrice);
-    m_priceAxis->setLabelFormat("%.2f");
-    m_priceAxis->setTickCount(5);
+    const OhlcvSeries& series = m_candlestickView->series();
+    if (series.isEmpty() || series.time().first() != endTime) {
+        return;
+    }
     
-    m_volumeAxis = new QValueAxis();
-    m_volumeAxis->setRange(0, maxVolume * 1.1);
-    m_volumeAxis->setLabelFormat("%d");
-    m_volumeAxis->setTickCount(3);
+    onCandlestickViewportChanged(m_candlestickView->firstVisibleBar(), m_candlestickView->visibleBarCount());
+}
+
+void QuoteChart::onIntradayDayLoaded(const QString& code, const QDate& date, bool ok)
+{
+    Q_UNUSED(date);
     
-    // 添加系列到图表
-    m_chart->addSeries(m_candleSeries);
-    m_chart->addSeries(m_candleVolumeSeries);
+    // 失败时保留当前图表并隐藏提示，切换股票或天数时再请求
+    if (!ok && m_intradayHistoryPending && code == m_renderedStockCode) {
+        showLoadingState(false);
+    }
     
-    // 添加坐标轴到图表
-    m_chart->addAxis(m_timeAxis, Qt::AlignBottom);
-    m_chart->addAxis(m_priceAxis, Qt::AlignLeft);
-    m_chart->addAxis(m_volumeAxis, Qt::AlignRight);
+    // 当前分时图还在等待往日数据时完整重建
+    if (!ok || !m_intradayHistoryPending || m_renderedChartType != ChartType::TimeSeries
+        || code != m_renderedStockCode) {
+        return;
+    }
     
-    // 关联系列到坐标轴
-    m_candleSeries->attachAxis(m_timeAxis);
-    m_candleSeries->attachAxis(m_priceAxis);
+    clearChart();
+    emit stockChanged(code);
+}
+
+QString QuoteChart::periodName() const
+{
+    switch (m_periodType) {
+    case PeriodType::Day:
+        return tr("日K");
+    case PeriodType::Week:
+        return tr("周K");
+    case PeriodType::Month:
+        return tr("月K");
+    case PeriodType::Minutes:
+        return tr("分钟K");
+    case PeriodType::Minutes5:
+        return tr("5分钟K");
+    case PeriodType::Minutes15:
+        return tr("15分钟K");
+    case PeriodType::Minutes30:
+        return tr("30分钟K");
+    case PeriodType::Minutes60:
+        return tr("60分钟K");
+    }
     
-    m_candleVolumeSeries->attachAxis(m_timeAxis);
-    m_candleVolumeSeries->attachAxis(m_volumeAxis);
+    return QString();
+}
+
+qint64 QuoteChart::barInterval() const
+{
+    const qint64 minute = 60 * 1000;
+    const qint64 day = 24 * 60 * minute;
     
-    // 设置图表布局
-    m_chart->layout()->setContentsMargins(0, 0, 0, 0);
+    switch (m_periodType) {
+    case PeriodType::Day:
+        return day;
+    case PeriodType::Week:
+        return 7 * day;
+    case PeriodType::Month:
+        return 30 * day;
+    case PeriodType::Minutes:
+        return minute;
+    case PeriodType::Minutes5:
+        return 5 * minute;
+    case PeriodType::Minutes15:
+        return 15 * minute;
+    case PeriodType::Minutes30:
+        return 30 * minute;
+    case PeriodType::Minutes60:
+        return 60 * minute;
+    }
     
-    // 显示图表
-    m_chartView->setChart(m_chart);
+    return day;
 }
 
 void QuoteChart::clearChart()
 {
+    // 移除前先放入缓存，切换回来时可直接恢复
+    stashRenderData();
+    
+    // 光标所依附的系列即将删除，鼠标再次移动时重新显示
+    hideTimeSeriesCrosshair();
+    
     // 清除所有系列和坐标轴
     m_chart->removeAllSeries();
     
@@ -444,14 +1228,29 @@ void QuoteChart::clearChart()
         m_volumeAxis = nullptr;
     }
     
+    if (m_volumeBarAxis) {
+        m_chart->removeAxis(m_volumeBarAxis);
+        delete m_volumeBarAxis;
+        m_volumeBarAxis = nullptr;
+    }
+    
     // 释放系列资源
     m_priceSeries = nullptr;  // 系列会由图表删除
+    m_averageSeries = nullptr;
+    m_limitUpSeries = nullptr;
+    m_limitDownSeries = nullptr;
     m_volumeSeries = nullptr;
-    m_candleSeries = nullptr;
-    m_candleVolumeSeries = nullptr;
+    m_volumeSet = nullptr;
+    
+    // 下次更新需要完整重建
+    m_renderedStockCode.clear();
+    m_intradayHistoryPending = false;
+    showLoadingState(false);
 }
 
 void QuoteChart::showLoadingState(bool isLoading)
 {
-    // 实现加载状态显示逻辑
+    if (m_loadingLabel) {
+        m_loadingLabel->setVisible(isLoading);
+    }
 } 
\ No newline at end of file
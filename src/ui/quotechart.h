@@ -1,12 +1,15 @@
 #pragma once
 
 #include "../data/stockitem.h"
+#include "candlestickview.h"
+#include "../data/klinehistory.h"
+#include "../data/intradayhistory.h"
+#include "../data/sessionaxis.h"
+#include "chartdatacache.h"
 #include <QWidget>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
-#include <QtCharts/QCandlestickSeries>
-#include <QtCharts/QCandlestickSet>
-#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QCategoryAxis>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QBarSeries>
 #include <QtCharts/QBarSet>
@@ -16,6 +19,9 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QStackedWidget>
+#include <QGraphicsLineItem>
+#include <QGraphicsSimpleTextItem>
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -72,6 +78,41 @@ public:
      * @param type 周期类型
      */
     void setPeriodType(PeriodType type);
+    
+    /**
+     * @brief 获取当前显示的股票代码
+     * @return 股票代码
+     */
+    QString getStockCode() const { return m_currentStockCode; }
+    
+    /**
+     * @brief 设置K线历史数据来源，K线图平移到左边缘时从中按块加载
+     * @param history 历史数据缓存，为nullptr时只显示实时K线
+     */
+    void setKLineHistory(KLineHistory *history);
+    
+    /**
+     * @brief 设置往日分时数据来源，多日分时图从中按日加载
+     * @param history 历史分时缓存，为nullptr时只显示当日分时
+     */
+    void setIntradayHistory(IntradayHistory *history);
+    
+    /**
+     * @brief 设置分时图显示的天数
+     * @param days 天数（1~10），包括当日
+     */
+    void setIntradayDays(int days);
+    
+    /**
+     * @brief 分时图显示的天数
+     */
+    int intradayDays() const { return m_intradayDays; }
+    
+    /**
+     * @brief 设置图表数据缓存的内存预算
+     * @param budgetKB 内存预算（KB），为0时不缓存，每次切换都完整重建
+     */
+    void setRenderCacheBudget(int budgetKB) { m_renderCache.setBudget(budgetKB); }
 
 signals:
     /**
@@ -87,11 +128,40 @@ private slots:
      */
     void onPeriodChanged(int index);
     
+    /**
+     * @brief 处理分时天数选择变化
+     * @param index 索引
+     */
+    void onIntradayDaysChanged(int index);
+    
     /**
      * @brief 处理图表类型按钮点击
      */
     void onTimeSeriesButtonClicked();
     void onCandlestickButtonClicked();
+    
+    /**
+     * @brief K线图可见范围变化，按需加载或释放历史K线
+     * @param firstBar 第一根可见K线的下标
+     * @param barCount 可见K线数量
+     */
+    void onCandlestickViewportChanged(int firstBar, int barCount);
+    
+    /**
+     * @brief 历史K线加载完成，正好是当前图表等待的一块时继续加载
+     */
+    void onKLineChunkLoaded(const QString& code, qint64 interval, qint64 endTime, bool ok);
+    
+    /**
+     * @brief 往日分时加载完成，当前分时图正在等待时重建
+     */
+    void onIntradayDayLoaded(const QString& code, const QDate& date, bool ok);
+
+protected:
+    /**
+     * @brief 跟踪分时图上的鼠标移动，显示十字光标
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
     /**
@@ -99,22 +169,142 @@ private:
      */
     void setupUI();
     
+    /**
+     * @brief 将分时图十字光标移到视图中的指定位置
+     * @param pos 视图坐标，不在绘图区内时隐藏光标
+     */
+    void updateTimeSeriesCrosshair(const QPoint& pos);
+    
+    /**
+     * @brief 隐藏分时图十字光标
+     */
+    void hideTimeSeriesCrosshair();
+    
+    /**
+     * @brief 时间轴位置上的分时数据（查表，O(1)）
+     * @param position 交易时段压缩后的位置
+     * @return 数据下标，该位置之前没有数据或已超出最新数据时返回-1
+     */
+    int timeSeriesIndexAt(int position) const;
+    
+    /**
+     * @brief 建立时间轴位置到分时数据下标的查找表
+     */
+    void buildPositionIndex();
+    
     /**
      * @brief 创建分时图
      * @param stock 股票数据
      */
     void createTimeSeriesChart(const StockItem& stock);
     
+    /**
+     * @brief 用准备好的数据构建分时图
+     * @param code 股票代码
+     * @param data 绘制数据
+     */
+    void applyTimeSeriesData(const QString& code, const ChartRenderData& data);
+    
     /**
      * @brief 创建K线图
      * @param stock 股票数据
      */
     void createCandlestickChart(const StockItem& stock);
     
+    /**
+     * @brief 用缓存的数据恢复K线图
+     * @param code 股票代码
+     * @param data 绘制数据
+     */
+    void applyCandlestickData(const QString& code, const ChartRenderData& data);
+    
+    /**
+     * @brief 从缓存恢复图表并按最新数据增量更新
+     * @param stock 股票数据
+     * @return 未命中缓存或恢复后无法增量更新时返回false
+     */
+    bool restoreChart(const StockItem& stock);
+    
+    /**
+     * @brief 把当前显示的图表数据放入缓存
+     */
+    void stashRenderData();
+    
+    /**
+     * @brief 生成图表数据的缓存键
+     */
+    QString cacheKey(const QString& code, ChartType chartType, PeriodType periodType, int intradayDays) const;
+    
+    /**
+     * @brief 增量更新分时图（更新最后一个点或追加一个点）
+     * @param stock 股票数据
+     * @return 无法增量更新时返回false，需要完整重建
+     */
+    bool updateTimeSeriesChart(const StockItem& stock);
+    
+    /**
+     * @brief 增量更新K线图（更新最后一根K线或追加一根K线）
+     * @param stock 股票数据
+     * @return 无法增量更新时返回false，需要完整重建
+     */
+    bool updateCandlestickChart(const StockItem& stock);
+    
+    /**
+     * @brief 计算以昨收为中心对称的价格轴范围，不超出涨跌停价
+     * @param low 需要显示的最低价
+     * @param high 需要显示的最高价
+     * @param minPrice 输出价格轴下限
+     * @param maxPrice 输出价格轴上限
+     */
+    void symmetricPriceRange(double low, double high, double *minPrice, double *maxPrice) const;
+    
+    /**
+     * @brief 新数据超出价格轴范围时扩展价格轴
+     * @param point 新的分时数据点
+     */
+    void extendTimeSeriesAxes(const TimeSeriesPoint& point);
+    
+    /**
+     * @brief 把成交量计入时间轴位置所在的柱子，超出成交量轴时扩展成交量轴
+     * @param position 时间轴位置
+     * @param volume 增加的成交量（可为负）
+     */
+    void addVolume(int position, qreal volume);
+    
+    /**
+     * @brief 找出降采样最后一列的起点和它在价格线末尾的点数
+     */
+    void locateLastColumn();
+    
+    /**
+     * @brief 重算降采样的最后一列，替换价格线和均价线末尾属于这一列的点
+     *
+     * 按时间轴位置分列，最后一个点更新或新增时只影响最后一列
+     */
+    void updateLastColumn();
+    
     /**
      * @brief 清除图表
      */
     void clearChart();
+    
+    /**
+     * @brief 获取当前周期的名称
+     * @return 周期名称，如"日K"
+     */
+    QString periodName() const;
+    
+    /**
+     * @brief 获取当前周期的K线间隔
+     * @return 间隔（毫秒）
+     */
+    qint64 barInterval() const;
+    
+    /**
+     * @brief 显示或隐藏加载状态
+     * @param isLoading 是否正在加载
+     */
+    void showLoadingState(bool isLoading);
 
 private:
     QChartView *m_chartView;           // 图表视图
@@ -122,19 +312,46 @@ private:
     
     // 分时图相关
     QLineSeries *m_priceSeries;         // 价格线
+    QLineSeries *m_averageSeries;       // 均价线
+    QLineSeries *m_limitUpSeries;       // 涨停价线
+    QLineSeries *m_limitDownSeries;     // 跌停价线
     QBarSeries *m_volumeSeries;         // 成交量柱状图
+    QBarSet *m_volumeSet;               // 成交量柱，每个交易分钟或每个降采样列一根
+    int m_decimationColumns;            // 价格线按多少像素列降采样，0表示未降采样
+    int m_lastColumnBegin;              // 降采样最后一列的第一个分时数据下标
+    int m_lastColumnPoints;             // 降采样最后一列在价格线末尾的点数
+    QVector<TimeSeriesPoint> m_timeSeriesData;  // 完整分时数据（多日拼接，十字光标读数用）
+    SessionAxis m_sessionAxis;          // 交易时段压缩的时间轴
+    QVector<int> m_positionIndex;       // 时间轴位置 -> 分时数据下标
+    int m_intradayHistoryPoints;        // 往日分时的点数，当日数据从此开始
+    int m_intradayDays;                 // 分时图显示的天数（1~10）
+    int m_renderedIntradayDays;         // 已绘制的天数
+    IntradayHistory *m_intradayHistory; // 往日分时数据来源
+    bool m_intradayHistoryPending;      // 当前分时图是否还有往日数据在加载
+    double m_previousClose;             // 昨收价
+    double m_limitUp;                   // 涨停价
+    double m_limitDown;                 // 跌停价
+    
+    // 分时图十字光标（图表上的图元，移动时只重绘图元经过的区域）
+    QGraphicsLineItem *m_crosshairVLine;
+    QGraphicsLineItem *m_crosshairHLine;
+    QGraphicsSimpleTextItem *m_crosshairText;
+    bool m_crosshairVisible;            // 鼠标是否停在绘图区内
+    QPoint m_crosshairPos;              // 光标在视图中的位置
     
-    // K线图相关
-    QCandlestickSeries *m_candleSeries; // K线图系列
-    QBarSeries *m_candleVolumeSeries;   // K线成交量柱状图
+    // K线图相关（QPainter直接绘制）
+    CandlestickView *m_candlestickView; // K线图视图
+    QStackedWidget *m_chartStack;       // 分时图/K线图切换
     
     // 坐标轴
-    QDateTimeAxis *m_timeAxis;          // 时间轴
+    QCategoryAxis *m_timeAxis;          // 时间轴（按交易时段压缩）
     QValueAxis *m_priceAxis;            // 价格轴
     QValueAxis *m_volumeAxis;           // 成交量轴
+    QValueAxis *m_volumeBarAxis;        // 成交量柱的隐藏横轴，把柱子下标对齐到时间轴
     
     // 控制组件
     QComboBox *m_periodComboBox;        // 周期选择
+    QComboBox *m_daysComboBox;          // 分时天数选择
     QPushButton *m_timeSeriesButton;    // 分时图按钮
     QPushButton *m_candlestickButton;   // K线图按钮
     QLabel *m_infoLabel;                // 信息标签
@@ -143,4 +360,15 @@ private:
     ChartType m_chartType;              // 当前图表类型
     PeriodType m_periodType;            // 当前周期类型
     QString m_currentStockCode;         // 当前股票代码
+    QString m_renderedStockCode;        // 已完整绘制的股票代码（用于增量更新）
+    ChartType m_renderedChartType;      // 已绘制的图表类型
+    PeriodType m_renderedPeriodType;    // 已绘制的K线周期
+    ChartDataCache m_renderCache;       // 最近看过的图表数据
+    
+    // K线历史数据
+    KLineHistory *m_kLineHistory;       // 历史数据来源
+    QVector<int> m_historyChunkSizes;   // 已加载的历史块大小，最早的在前
+    int m_historyBars;                  // 已加载的历史K线数量
+    bool m_historyExhausted;            // 是否已没有更早的历史
+    QLabel *m_loadingLabel;             // 加载状态标签
 }; 
\ No newline at end of file
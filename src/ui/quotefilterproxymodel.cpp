@@ -0,0 +1,59 @@
+#include "quotefilterproxymodel.h"
+#include "quotemodel.h"
+
+QuoteFilterProxyModel::QuoteFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_filterByMarketType(false)
+    , m_marketType(StockItem::MarketType::Unknown)
+    , m_filterByCode(false)
+{
+    // 使用UserRole进行排序
+    setSortRole(Qt::UserRole);
+}
+
+QuoteFilterProxyModel::~QuoteFilterProxyModel()
+{
+}
+
+void QuoteFilterProxyModel::setMarketTypeFilter(StockItem::MarketType type)
+{
+    m_filterByMarketType = true;
+    m_marketType = type;
+    invalidateFilter();
+}
+
+void QuoteFilterProxyModel::setCodeFilter(const QSet<QString>& codes)
+{
+    m_filterByCode = true;
+    m_codes = codes;
+    invalidateFilter();
+}
+
+void QuoteFilterProxyModel::clearFilter()
+{
+    m_filterByMarketType = false;
+    m_filterByCode = false;
+    m_codes.clear();
+    invalidateFilter();
+}
+
+bool QuoteFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    const QuoteModel *model = qobject_cast<const QuoteModel*>(sourceModel());
+    const StockItem *stock = model ? model->stockAt(sourceRow) : nullptr;
+    if (!stock) {
+        return false;
+    }
+
+    if (m_filterByMarketType && stock->getMarketType() != m_marketType) {
+        return false;
+    }
+
+    if (m_filterByCode && !m_codes.contains(stock->getCode())) {
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
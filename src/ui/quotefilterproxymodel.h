@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../data/stockitem.h"
+#include <QSortFilterProxyModel>
+#include <QSet>
+
+/**
+ * @brief 看板排序过滤代理模型
+ *
+ * 每个看板一个，按市场类型或自选股列表过滤共享的行情模型
+ */
+class QuoteFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit QuoteFilterProxyModel(QObject *parent = nullptr);
+    ~QuoteFilterProxyModel();
+
+    /**
+     * @brief 设置市场类型过滤
+     * @param type 市场类型
+     */
+    void setMarketTypeFilter(StockItem::MarketType type);
+
+    /**
+     * @brief 设置股票代码过滤（自选股）
+     * @param codes 股票代码集合
+     */
+    void setCodeFilter(const QSet<QString>& codes);
+
+    /**
+     * @brief 清除所有过滤条件
+     */
+    void clearFilter();
+
+protected:
+    /**
+     * @brief 判断源模型的行是否显示
+     */
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    bool m_filterByMarketType;             // 是否按市场类型过滤
+    StockItem::MarketType m_marketType;    // 市场类型
+    bool m_filterByCode;                   // 是否按代码过滤
+    QSet<QString> m_codes;                 // 股票代码集合
+};
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "quotemodel.h"
+#include "../data/tracer.h"
+#include <QColor>
+#include <algorithm>
+
+namespace {
+
+// 需要通知视图的一段单元格
+struct ChangedCells {
+    int firstRow;
+    int lastRow;
+    int firstColumn;
+    int lastColumn;
+};
+
+} // namespace
+
+QuoteModel::QuoteModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_flashAnimator(nullptr)
+    , m_rowsCharge(MemoryAccounting::TableModelTag)
+{
+    m_flashAnimator = new FlashAnimator(this);
+}
+
+QuoteModel::~QuoteModel()
+{
+}
+
+void QuoteModel::setMarketData(const MarketData& marketData)
+{
+    TRACE_SCOPE("QuoteModel::setMarketData");
+    const QMap<QString, StockItem>& stocks = marketData.getAllStocks();
+
+    // 判断股票集合是否变化
+    bool sameUniverse = stocks.size() == m_rows.size();
+    if (sameUniverse) {
+        int row = 0;
+        for (auto it = stocks.cbegin(); it != stocks.cend(); ++it, ++row) {
+            if (it.key() != m_rows[row]->getCode()) {
+                sameUniverse = false;
+                break;
+            }
+        }
+    }
+
+    if (!sameUniverse) {
+        beginResetModel();
+        m_marketData = marketData;
+        m_rows.clear();
+        m_rows.reserve(stocks.size());
+        m_rowByCode.clear();
+        m_rowByCode.reserve(stocks.size());
+        for (auto it = stocks.cbegin(); it != stocks.cend(); ++it) {
+            m_rowByCode.insert(it.key(), m_rows.size());
+            m_rows.append(&it.value());
+        }
+        m_flashAnimator->resize(m_rows.size());
+        m_pendingFields.clear();
+        endResetModel();
+        
+        // 股票数据与数据管理器共享，只登记模型自己的部分：行映射、代码索引和每行一字节的闪烁状态
+        m_rowsCharge.set(qint64(m_rows.capacity()) * sizeof(const StockItem*)
+                         + qint64(m_rowByCode.size()) * (sizeof(QString) + sizeof(int))
+                         + qint64(m_rows.size()) * sizeof(qint8));
+        return;
+    }
+
+    // 旧数据在比较完成前保持有效
+    MarketData previous = m_marketData;
+    m_marketData = marketData;
+
+    // 按订阅报告的字段确定变化的单元格：价格影响现价到最低价，成交影响成交量和成交额
+    QVector<ChangedCells> changed;
+    changed.reserve(m_pendingFields.size());
+    for (auto it = m_pendingFields.cbegin(); it != m_pendingFields.cend(); ++it) {
+        int row = m_rowByCode.value(it.key(), -1);
+        if (row < 0) {
+            continue;
+        }
+
+        int firstColumn = ColumnCount;
+        int lastColumn = -1;
+        if (it.value() & DataManager::PriceField) {
+            firstColumn = ColPrice;
+            lastColumn = ColLow;
+
+            // 涨跌方向变化时整行换色
+            const StockItem *stock = marketData.getStock(it.key());
+            if (stock && getStockColor(stock->getChangePercent())
+                             != getStockColor(m_rows[row]->getChangePercent())) {
+                firstColumn = ColCode;
+                lastColumn = ColumnCount - 1;
+            }
+        }
+        if (it.value() & DataManager::VolumeField) {
+            firstColumn = qMin(firstColumn, int(ColVolume));
+            lastColumn = qMax(lastColumn, int(ColAmount));
+        }
+
+        if (lastColumn >= firstColumn) {
+            changed.append({row, row, firstColumn, lastColumn});
+        }
+    }
+    m_pendingFields.clear();
+
+    int row = 0;
+    for (auto it = stocks.cbegin(); it != stocks.cend(); ++it, ++row) {
+        const StockItem *stock = &it.value();
+        double oldPrice = m_rows[row]->getCurrentPrice();
+
+        // 现价变化时触发闪烁
+        if (stock->getCurrentPrice() > oldPrice) {
+            m_flashAnimator->trigger(row, 1);
+        } else if (stock->getCurrentPrice() < oldPrice) {
+            m_flashAnimator->trigger(row, -1);
+        }
+
+        m_rows[row] = stock;
+    }
+
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    // 相邻且列范围相同的行合并为一次通知
+    std::sort(changed.begin(), changed.end(), [](const ChangedCells& a, const ChangedCells& b) {
+        return a.firstRow < b.firstRow;
+    });
+
+    ChangedCells range = changed.first();
+    for (int i = 1; i < changed.size(); ++i) {
+        const ChangedCells& next = changed[i];
+        if (next.firstRow == range.lastRow + 1
+            && next.firstColumn == range.firstColumn && next.lastColumn == range.lastColumn) {
+            range.lastRow = next.firstRow;
+            continue;
+        }
+
+        emit dataChanged(index(range.firstRow, range.firstColumn), index(range.lastRow, range.lastColumn));
+        range = next;
+    }
+    emit dataChanged(index(range.firstRow, range.firstColumn), index(range.lastRow, range.lastColumn));
+}
+
+void QuoteModel::markChanged(const QVector<DataManager::StockUpdate>& updates)
+{
+    for (const DataManager::StockUpdate& update : updates) {
+        m_pendingFields[update.code] |= update.fields;
+    }
+}
+
+const StockItem* QuoteModel::stockAt(int row) const
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return nullptr;
+    }
+
+    return m_rows[row];
+}
+
+int QuoteModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int QuoteModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant QuoteModel::data(const QModelIndex& index, int role) const
+{
+    const StockItem *stock = stockAt(index.row());
+    if (!stock) {
+        return QVariant();
+    }
+
+    if (role == Qt::ForegroundRole) {
+        return getStockColor(stock->getChangePercent());
+    }
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case ColCode:
+            return stock->getCode();
+        case ColName:
+            return stock->getName();
+        case ColPrice:
+            return QString::number(stock->getCurrentPrice(), 'f', 2);
+        case ColChange:
+            return QString::number(stock->getChange(), 'f', 2);
+        case ColChangePercent:
+            return QString::number(stock->getChangePercent(), 'f', 2) + "%";
+        case ColOpen:
+            return QString::number(stock->getOpenPrice(), 'f', 2);
+        case ColHigh:
+            return QString::number(stock->getHighPrice(), 'f', 2);
+        case ColLow:
+            return QString::number(stock->getLowPrice(), 'f', 2);
+        case ColVolume:
+            // 成交量（以万为单位）
+            return QString::number(stock->getVolume() / 10000.0, 'f', 0) + tr("万");
+        case ColAmount:
+            // 成交额（以万为单位）
+            return QString::number(stock->getAmount() / 10000.0, 'f', 0) + tr("万");
+        }
+    }
+
+    // 排序使用原始数值
+    if (role == Qt::UserRole) {
+        switch (index.column()) {
+        case ColCode:
+            return stock->getCode();
+        case ColName:
+            return stock->getName();
+        case ColPrice:
+            return stock->getCurrentPrice();
+        case ColChange:
+            return stock->getChange();
+        case ColChangePercent:
+            return stock->getChangePercent();
+        case ColOpen:
+            return stock->getOpenPrice();
+        case ColHigh:
+            return stock->getHighPrice();
+        case ColLow:
+            return stock->getLowPrice();
+        case ColVolume:
+            return stock->getVolume();
+        case ColAmount:
+            return stock->getAmount();
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant QuoteModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case ColCode:
+        return tr("代码");
+    case ColName:
+        return tr("名称");
+    case ColPrice:
+        return tr("当前价");
+    case ColChange:
+        return tr("涨跌额");
+    case ColChangePercent:
+        return tr("涨跌幅");
+    case ColOpen:
+        return tr("开盘价");
+    case ColHigh:
+        return tr("最高价");
+    case ColLow:
+        return tr("最低价");
+    case ColVolume:
+        return tr("成交量");
+    case ColAmount:
+        return tr("成交额");
+    }
+
+    return QVariant();
+}
+
+QColor QuoteModel::getStockColor(double changePercent) const
+{
+    if (changePercent > 0) {
+        return QColor(255, 0, 0);  // 红色表示上涨
+    } else if (changePercent < 0) {
+        return QColor(0, 128, 0);  // 绿色表示下跌
+    } else {
+        return QColor(0, 0, 0);    // 黑色表示平盘
+    }
+}
\ No newline at end of file
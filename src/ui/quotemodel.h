@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../data/marketdata.h"
+#include "../data/datamanager.h"
+#include "flashanimator.h"
+#include "../data/memoryaccounting.h"
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QHash>
+
+/**
+ * @brief 行情表格模型类
+ *
+ * 所有看板共享的行情数据模型，直接读取市场数据，不为单元格创建对象；
+ * 视图只为可见单元格取数，新增看板只需增加一个排序过滤代理
+ */
+class QuoteModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    // 列索引常量
+    enum Column {
+        ColCode = 0,           // 代码
+        ColName = 1,           // 名称
+        ColPrice = 2,          // 当前价
+        ColChange = 3,         // 涨跌额
+        ColChangePercent = 4,  // 涨跌幅
+        ColOpen = 5,           // 开盘价
+        ColHigh = 6,           // 最高价
+        ColLow = 7,            // 最低价
+        ColVolume = 8,         // 成交量
+        ColAmount = 9,         // 成交额
+        ColumnCount = 10
+    };
+
+public:
+    explicit QuoteModel(QObject *parent = nullptr);
+    ~QuoteModel();
+
+    /**
+     * @brief 设置市场数据
+     *
+     * 股票集合不变时只为 markChanged() 记录的行和列发出数据变化信号并触发涨跌闪烁，
+     * 否则重置模型
+     * @param marketData 市场数据
+     */
+    void setMarketData(const MarketData& marketData);
+
+    /**
+     * @brief 记录订阅回调报告的变化，下一次 setMarketData() 时只通知这些单元格
+     * @param updates 变化的股票及字段
+     */
+    void markChanged(const QVector<DataManager::StockUpdate>& updates);
+
+    /**
+     * @brief 获取市场数据
+     */
+    const MarketData& getMarketData() const { return m_marketData; }
+
+    /**
+     * @brief 获取指定行的股票
+     * @param row 行号
+     * @return 股票对象指针，行号无效时返回nullptr
+     */
+    const StockItem* stockAt(int row) const;
+
+    /**
+     * @brief 获取现价涨跌闪烁动画（按行号索引，所有看板共用）
+     */
+    FlashAnimator* flashAnimator() const { return m_flashAnimator; }
+
+    // QAbstractTableModel 接口
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    /**
+     * @brief 获取股票颜色（涨跌颜色）
+     * @param changePercent 涨跌幅
+     * @return 颜色
+     */
+    QColor getStockColor(double changePercent) const;
+
+private:
+    MarketData m_marketData;               // 市场数据（与数据管理器隐式共享）
+    QVector<const StockItem*> m_rows;      // 行号到股票的映射
+    QHash<QString, int> m_rowByCode;       // 股票代码到行号的映射
+    QHash<QString, DataManager::StockFields> m_pendingFields;  // 待通知的变化字段
+    FlashAnimator *m_flashAnimator;        // 现价涨跌闪烁动画
+    MemoryCharge m_rowsCharge;             // 行映射和闪烁状态的内存登记
+};
\ No newline at end of file
@@ -0,0 +1,380 @@
+#include "sparklinegrid.h"
+#include "../data/tracer.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QtMath>
+
+namespace {
+
+const QColor kUpColor(255, 0, 0);       // 红色表示上涨
+const QColor kDownColor(0, 128, 0);     // 绿色表示下跌
+const QColor kFlatColor(0, 0, 0);       // 黑色表示平盘
+const QColor kBaselineColor(160, 160, 160);
+const QColor kBorderColor(220, 220, 220);
+
+const int kCellWidth = 160;      // 单元格宽度
+const int kCellHeight = 72;      // 单元格高度
+const int kPadding = 4;          // 单元格内边距
+const int kHeaderHeight = 16;    // 名称和价格所占高度
+const int kSessionMinutes = 240; // 全天交易分钟数，不足一天时折线只占左侧
+
+/**
+ * @brief 单元格内折线区域（相对单元格左上角）
+ */
+QRectF plotArea()
+{
+    return QRectF(kPadding, kPadding + kHeaderHeight,
+                  kCellWidth - 2 * kPadding, kCellHeight - kHeaderHeight - 2 * kPadding);
+}
+
+} // namespace
+
+SparklineGrid::SparklineGrid(QWidget *parent)
+    : QWidget(parent)
+    , m_allChanged(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAutoFillBackground(false);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+}
+
+SparklineGrid::~SparklineGrid()
+{
+}
+
+void SparklineGrid::setCodes(const QStringList& codes)
+{
+    m_cells.clear();
+    m_cellIndex.clear();
+    m_changedCodes.clear();
+
+    m_cells.reserve(codes.size());
+    for (const QString& code : codes) {
+        if (m_cellIndex.contains(code)) {
+            continue;
+        }
+        Cell cell;
+        cell.code = code;
+        cell.name = code;
+        m_cellIndex.insert(code, m_cells.size());
+        m_cells.append(cell);
+    }
+
+    m_allChanged = true;
+    updateGeometry();
+    setMinimumHeight(heightForWidth(width()));
+    update();
+}
+
+QStringList SparklineGrid::codes() const
+{
+    QStringList result;
+    result.reserve(m_cells.size());
+    for (const Cell& cell : m_cells) {
+        result.append(cell.code);
+    }
+    return result;
+}
+
+void SparklineGrid::markChanged(const QStringList& codes)
+{
+    if (m_allChanged) {
+        return;
+    }
+    for (const QString& code : codes) {
+        if (m_cellIndex.contains(code)) {
+            m_changedCodes.insert(code);
+        }
+    }
+}
+
+void SparklineGrid::refresh(const MarketData& marketData)
+{
+    TRACE_SCOPE("SparklineGrid::refresh");
+    if (!m_allChanged && m_changedCodes.isEmpty()) {
+        return;
+    }
+
+    // 只重新计算有变化的单元格，数据实际未变时不重绘
+    QRegion dirty;
+    auto refreshCell = [&](int index) {
+        const StockItem* stock = marketData.getStock(m_cells[index].code);
+        if (stock && prepareCell(m_cells[index], *stock)) {
+            dirty += cellRect(index);
+        }
+    };
+
+    if (m_allChanged) {
+        for (int i = 0; i < m_cells.size(); ++i) {
+            refreshCell(i);
+        }
+    } else {
+        for (const QString& code : m_changedCodes) {
+            refreshCell(m_cellIndex.value(code));
+        }
+    }
+
+    m_allChanged = false;
+    m_changedCodes.clear();
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+bool SparklineGrid::prepareCell(Cell& cell, const StockItem& stock)
+{
+    int count = stock.getTimeSeriesCount();
+    double lastPointPrice = count > 0 ? stock.getLastTimeSeriesPoint().price : 0.0;
+
+    // 点数、最新点、现价和昨收都没变时折线不变
+    if (cell.pointCount == count && cell.lastPointPrice == lastPointPrice
+        && cell.currentPrice == stock.getCurrentPrice()
+        && cell.previousClose == stock.getPreviousClose()) {
+        return false;
+    }
+
+    cell.pointCount = count;
+    cell.lastPointPrice = lastPointPrice;
+    cell.currentPrice = stock.getCurrentPrice();
+    cell.previousClose = stock.getPreviousClose();
+
+    // 名称登记后不变，只在第一次拿到名称时重新排版
+    if (cell.name == cell.code) {
+        QString name = stock.getName();
+        if (!name.isEmpty()) {
+            cell.name = name;
+            cell.nameWidth = -1;
+        }
+    }
+
+    double change = stock.getChangePercent();
+    cell.priceText = QString("%1 %2%3%")
+                         .arg(cell.currentPrice, 0, 'f', 2)
+                         .arg(change > 0 ? "+" : "")
+                         .arg(change, 0, 'f', 2);
+    if (cell.currentPrice > cell.previousClose) {
+        cell.direction = 1;
+    } else if (cell.currentPrice < cell.previousClose) {
+        cell.direction = -1;
+    } else {
+        cell.direction = 0;
+    }
+
+    cell.points.clear();
+    QRectF area = plotArea();
+    if (count == 0) {
+        cell.baselineY = area.center().y();
+        return true;
+    }
+
+    // 横轴按全天分钟数排列，点数超过两倍像素列时按列降采样，每列只保留最低点和最高点；
+    // 全局极值在同一遍扫描中求出
+    int slots = qMax(count, kSessionMinutes);
+    double xStep = slots > 1 ? area.width() / (slots - 1) : 0.0;
+    int columns = qMax(1, qCeil(count * xStep));
+    if (count <= columns * 2) {
+        columns = count;
+    }
+
+    double lowPrice = stock.getTimeSeriesPoint(0).price;
+    double highPrice = lowPrice;
+    m_indices.clear();
+    m_indices.reserve(qMin(count, columns * 2));
+    for (int column = 0; column < columns; ++column) {
+        int begin = int(qint64(count) * column / columns);
+        int end = int(qint64(count) * (column + 1) / columns);
+        if (begin >= end) {
+            continue;
+        }
+
+        int minIndex = begin;
+        int maxIndex = begin;
+        for (int i = begin + 1; i < end; ++i) {
+            double price = stock.getTimeSeriesPoint(i).price;
+            if (price < stock.getTimeSeriesPoint(minIndex).price) {
+                minIndex = i;
+            } else if (price > stock.getTimeSeriesPoint(maxIndex).price) {
+                maxIndex = i;
+            }
+        }
+        lowPrice = qMin(lowPrice, stock.getTimeSeriesPoint(minIndex).price);
+        highPrice = qMax(highPrice, stock.getTimeSeriesPoint(maxIndex).price);
+
+        // 按时间先后输出，保证折线走向正确
+        m_indices.append(qMin(minIndex, maxIndex));
+        if (minIndex != maxIndex) {
+            m_indices.append(qMax(minIndex, maxIndex));
+        }
+    }
+
+    // 纵轴以昨收为中心对称，涨跌幅度一目了然
+    double base = cell.previousClose > 0 ? cell.previousClose : stock.getTimeSeriesPoint(0).price;
+    double amplitude = qMax(qAbs(highPrice - base), qAbs(lowPrice - base));
+    if (amplitude <= 0) {
+        amplitude = base > 0 ? base * 0.01 : 1.0;
+    }
+    double minPrice = base - amplitude;
+    double priceSpan = 2 * amplitude;
+
+    cell.points.reserve(m_indices.size());
+    for (int index : m_indices) {
+        double x = area.left() + index * xStep;
+        double y = area.bottom() - (stock.getTimeSeriesPoint(index).price - minPrice) / priceSpan * area.height();
+        cell.points.append(QPointF(x, y));
+    }
+    cell.baselineY = area.bottom() - (base - minPrice) / priceSpan * area.height();
+    return true;
+}
+
+QRect SparklineGrid::cellRect(int index) const
+{
+    int columns = columnCount(width());
+    return QRect((index % columns) * kCellWidth, (index / columns) * kCellHeight, kCellWidth, kCellHeight);
+}
+
+int SparklineGrid::columnCount(int width) const
+{
+    return qMax(1, width / kCellWidth);
+}
+
+int SparklineGrid::heightForWidth(int width) const
+{
+    int columns = columnCount(width);
+    int rows = (m_cells.size() + columns - 1) / columns;
+    return rows * kCellHeight;
+}
+
+QSize SparklineGrid::sizeHint() const
+{
+    int columns = 5;
+    return QSize(columns * kCellWidth, heightForWidth(columns * kCellWidth));
+}
+
+void SparklineGrid::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    // 列数随宽度变化，高度跟随，使滚动区域能够滚动到最后一行
+    setMinimumHeight(heightForWidth(width()));
+}
+
+void SparklineGrid::changeEvent(QEvent *event)
+{
+    QWidget::changeEvent(event);
+
+    // 字体变化后名称需要重新省略和排版
+    if (event->type() == QEvent::FontChange) {
+        for (Cell& cell : m_cells) {
+            cell.nameWidth = -1;
+        }
+    }
+}
+
+void SparklineGrid::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    QPoint pos = event->position().toPoint();
+    int columns = columnCount(width());
+    int column = pos.x() / kCellWidth;
+    int index = (pos.y() / kCellHeight) * columns + column;
+    if (column < columns && index >= 0 && index < m_cells.size()) {
+        emit stockSelected(m_cells[index].code);
+    }
+    QWidget::mouseDoubleClickEvent(event);
+}
+
+void SparklineGrid::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().color(QPalette::Base));
+
+    if (m_cells.isEmpty()) {
+        return;
+    }
+
+    // 只处理与重绘区域相交的单元格
+    QRect bounds = event->rect();
+    int columns = columnCount(width());
+    int firstRow = qMax(0, bounds.top() / kCellHeight);
+    int lastRow = bounds.bottom() / kCellHeight;
+    int firstColumn = qMax(0, bounds.left() / kCellWidth);
+    int lastColumn = qMin(columns - 1, bounds.right() / kCellWidth);
+
+    m_upLines.clear();
+    m_downLines.clear();
+    m_flatLines.clear();
+    m_baseLines.clear();
+
+    m_borders.clear();
+
+    QVector<int> visibleCells;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            int index = row * columns + column;
+            if (index >= m_cells.size()) {
+                break;
+            }
+            QRect rect = cellRect(index);
+            if (!event->region().intersects(rect)) {
+                continue;
+            }
+            visibleCells.append(index);
+
+            // 收集线段，所有单元格的同色线段一次绘制
+            const Cell& cell = m_cells[index];
+            QPointF offset = rect.topLeft();
+            QVector<QLineF>& lines = cell.direction > 0 ? m_upLines
+                                   : cell.direction < 0 ? m_downLines : m_flatLines;
+            for (int i = 1; i < cell.points.size(); ++i) {
+                lines.append(QLineF(cell.points[i - 1] + offset, cell.points[i] + offset));
+            }
+
+            QRectF area = plotArea().translated(offset);
+            double baselineY = offset.y() + cell.baselineY;
+            m_baseLines.append(QLineF(area.left(), baselineY, area.right(), baselineY));
+            m_borders.append(rect.adjusted(0, 0, -1, -1));
+        }
+    }
+
+    // 单元格边框
+    painter.setPen(kBorderColor);
+    painter.drawRects(m_borders);
+
+    // 昨收基准线
+    painter.setPen(QPen(kBaselineColor, 1, Qt::DashLine));
+    painter.drawLines(m_baseLines);
+
+    // 价格线
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(kUpColor, 1));
+    painter.drawLines(m_upLines);
+    painter.setPen(QPen(kDownColor, 1));
+    painter.drawLines(m_downLines);
+    painter.setPen(QPen(kFlatColor, 1));
+    painter.drawLines(m_flatLines);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    // 名称和价格，名称使用缓存的QStaticText，价格宽度不变时不重新省略和排版
+    QFontMetrics metrics = painter.fontMetrics();
+    int nameTop = (kHeaderHeight - metrics.height()) / 2;
+    for (int index : visibleCells) {
+        Cell& cell = m_cells[index];
+        QRect header = cellRect(index).adjusted(kPadding, kPadding, -kPadding, 0);
+        header.setHeight(kHeaderHeight);
+
+        painter.setPen(palette().color(QPalette::Text));
+        int priceWidth = metrics.horizontalAdvance(cell.priceText);
+        int nameWidth = header.width() - priceWidth - kPadding;
+        if (cell.nameWidth != nameWidth) {
+            cell.nameText.setText(metrics.elidedText(cell.name, Qt::ElideRight, nameWidth));
+            cell.nameText.setTextFormat(Qt::PlainText);
+            cell.nameText.prepare(painter.transform(), painter.font());
+            cell.nameWidth = nameWidth;
+        }
+        painter.drawStaticText(header.left(), header.top() + nameTop, cell.nameText);
+
+        painter.setPen(cell.direction > 0 ? kUpColor : cell.direction < 0 ? kDownColor : kFlatColor);
+        painter.drawText(header, Qt::AlignRight | Qt::AlignVCenter, cell.priceText);
+    }
+}
\ No newline at end of file
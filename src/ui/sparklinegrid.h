@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../data/marketdata.h"
+#include <QWidget>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QLineF>
+#include <QPointF>
+#include <QStringList>
+#include <QStaticText>
+
+/**
+ * @brief 分时走势网格
+ *
+ * 以固定大小的单元格同时显示大量股票的迷你分时图：价格线、昨收基准线，
+ * 线条按涨跌着色。每个单元格的折线在数据变化时预先计算好（按像素列降采样），
+ * 只有发生变化的单元格会被重绘；一次绘制中所有单元格的线段按颜色收集后批量绘制
+ */
+class SparklineGrid : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SparklineGrid(QWidget *parent = nullptr);
+    ~SparklineGrid();
+
+    /**
+     * @brief 设置显示的股票
+     * @param codes 股票代码列表，按顺序排列
+     */
+    void setCodes(const QStringList& codes);
+
+    /**
+     * @brief 获取显示的股票
+     */
+    QStringList codes() const;
+
+    /**
+     * @brief 标记股票的行情已变化，下次refresh时重新计算
+     * @param codes 股票代码
+     */
+    void markChanged(const QStringList& codes);
+
+    /**
+     * @brief 重新计算已变化的单元格并安排重绘
+     * @param marketData 最新的市场数据
+     */
+    void refresh(const MarketData& marketData);
+
+    /**
+     * @brief 按宽度计算所需高度
+     */
+    bool hasHeightForWidth() const override { return true; }
+    int heightForWidth(int width) const override;
+    QSize sizeHint() const override;
+
+signals:
+    /**
+     * @brief 双击单元格选中股票
+     * @param code 股票代码
+     */
+    void stockSelected(const QString& code);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    /**
+     * @brief 单元格预先计算好的绘制数据（坐标相对单元格左上角）
+     */
+    struct Cell {
+        QString code;
+        QString name;
+        QStaticText nameText;      // 按可用宽度省略后的名称，缓存排版结果
+        int nameWidth = -1;        // nameText对应的可用宽度，-1表示需要重新排版
+        QString priceText;         // 现价和涨跌幅
+        QVector<QPointF> points;   // 价格折线
+        double baselineY = 0.0;    // 昨收基准线
+        int direction = 0;         // 1上涨，-1下跌，0平盘
+
+        // 用于判断数据是否变化
+        int pointCount = -1;
+        double lastPointPrice = 0.0;
+        double currentPrice = 0.0;
+        double previousClose = 0.0;
+    };
+
+    /**
+     * @brief 按股票数据重新计算单元格
+     * @return 数据有变化时返回true
+     */
+    bool prepareCell(Cell& cell, const StockItem& stock);
+
+    /**
+     * @brief 单元格在控件中的位置
+     */
+    QRect cellRect(int index) const;
+
+    /**
+     * @brief 每行的单元格数量
+     */
+    int columnCount(int width) const;
+
+private:
+    QVector<Cell> m_cells;             // 单元格，按显示顺序
+    QHash<QString, int> m_cellIndex;   // 股票代码 -> 单元格下标
+    QSet<QString> m_changedCodes;      // 待重新计算的股票
+    bool m_allChanged;                 // 是否全部需要重新计算
+
+    // 重新计算单元格时复用的降采样下标缓冲区
+    QVector<int> m_indices;
+
+    // 每次绘制复用的线段缓冲区，按颜色分组
+    QVector<QLineF> m_upLines;
+    QVector<QLineF> m_downLines;
+    QVector<QLineF> m_flatLines;
+    QVector<QLineF> m_baseLines;
+    QVector<QRect> m_borders;
+};
\ No newline at end of file
@@ -1,33 +1,28 @@
 #pragma once
 
-#include "../data/marketdata.h"
+#include "quotemodel.h"
+#include "quotefilterproxymodel.h"
 #include <QTableView>
-#include <QStandardItemModel>
-#include <QSortFilterProxyModel>
 #include <QMenu>
 #include <QAction>
 #include <QContextMenuEvent>
+#include <QKeyEvent>
 #include <QHeaderView>
 
 /**
  * @brief 股票表格类
  * 
- * 用于显示股票列表和行情数据
+ * 用于显示股票列表和行情数据，多个表格共享同一个行情模型，
+ * 每个表格只持有自己的排序过滤代理
  */
 class StockTable : public QTableView
 {
     Q_OBJECT
 
 public:
-    explicit StockTable(QWidget *parent = nullptr);
+    explicit StockTable(QuoteModel *model, QWidget *parent = nullptr);
     ~StockTable();
     
-    /**
-     * @brief 更新表格数据
-     * @param marketData 市场数据
-     */
-    void updateData(const MarketData& marketData);
-    
     /**
      * @brief 设置过滤器，只显示指定市场类型的股票
      * @param type 市场类型
@@ -38,6 +33,12 @@ public:
      * @brief 清除过滤器，显示所有股票
      */
     void clearFilter();
+    
+    /**
+     * @brief 设置过滤器，只显示指定代码的股票（自选股）
+     * @param codes 股票代码集合
+     */
+    void setCodeFilter(const QSet<QString>& codes);
 
 signals:
     /**
@@ -46,6 +47,24 @@ signals:
      */
     void stockSelected(const QString& code);
 
+    /**
+     * @brief 请求打开键盘精灵信号
+     * @param text 触发的按键文本
+     */
+    void symbolSearchRequested(const QString& text);
+
+    /**
+     * @brief 请求加入自选股信号
+     * @param code 股票代码
+     */
+    void addToWatchlistRequested(const QString& code);
+
+    /**
+     * @brief 请求移出自选股信号
+     * @param code 股票代码
+     */
+    void removeFromWatchlistRequested(const QString& code);
+
 protected:
     /**
      * @brief 处理上下文菜单事件
@@ -53,6 +72,12 @@ protected:
      */
     void contextMenuEvent(QContextMenuEvent* event) override;
     
+    /**
+     * @brief 处理按键事件，输入字母或数字时打开键盘精灵
+     * @param event 事件对象
+     */
+    void keyPressEvent(QKeyEvent* event) override;
+    
 private slots:
     /**
      * @brief 处理表格项选择
@@ -75,44 +100,40 @@ private slots:
      * @brief 复制选中的行
      */
     void copySelectedRow();
+    
+    /**
+     * @brief 将选中的股票加入自选股
+     */
+    void addSelectedToWatchlist();
+    
+    /**
+     * @brief 将选中的股票移出自选股
+     */
+    void removeSelectedFromWatchlist();
+    
+    /**
+     * @brief 重绘闪烁状态变化的单元格
+     * @param rows 源模型中的行号
+     */
+    void onFlashCellsChanged(const QVector<int>& rows);
 
 private:
     /**
      * @brief 初始化表格模型
+     * @param model 共享的行情模型
      */
-    void setupModel();
+    void setupModel(QuoteModel *model);
     
     /**
      * @brief 设置表格样式
      */
     void setupStyle();
-    
-    /**
-     * @brief 获取股票颜色（涨跌颜色）
-     * @param changePercent 涨跌幅
-     * @return 颜色
-     */
-    QColor getStockColor(double changePercent) const;
 
 private:
-    QStandardItemModel* m_model;              // 数据模型
-    QSortFilterProxyModel* m_proxyModel;      // 排序过滤代理模型
+    QuoteModel* m_model;                      // 共享的行情模型
+    QuoteFilterProxyModel* m_proxyModel;      // 排序过滤代理模型
     QMenu* m_contextMenu;                     // 右键菜单
     
     // 当前选中的股票代码
     QString m_selectedStockCode;
-    
-    // 列索引常量
-    enum ColumnIndex {
-        ColCode = 0,           // 代码
-        ColName = 1,           // 名称
-        ColPrice = 2,          // 当前价
-        ColChange = 3,         // 涨跌额
-        ColChangePercent = 4,  // 涨跌幅
-        ColOpen = 5,           // 开盘价
-        ColHigh = 6,           // 最高价
-        ColLow = 7,            // 最低价
-        ColVolume = 8,         // 成交量
-        ColAmount = 9          // 成交额
-    };
-}; 
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "symbolsearch.h"
+#include <QVBoxLayout>
+
+SymbolSearch::SymbolSearch(QWidget *parent)
+    : QFrame(parent, Qt::Popup)
+    , m_lineEdit(nullptr)
+    , m_resultList(nullptr)
+{
+    setupUI();
+}
+
+SymbolSearch::~SymbolSearch()
+{
+}
+
+void SymbolSearch::setMarketData(const MarketData& marketData)
+{
+    // 股票集合不变时保留原索引
+    if (!m_index.matches(marketData)) {
+        m_index.build(marketData);
+    }
+}
+
+void SymbolSearch::popup(const QString& text)
+{
+    // 显示在父窗口右下角
+    if (parentWidget()) {
+        QWidget *window = parentWidget()->window();
+        QPoint bottomRight = window->mapToGlobal(window->rect().bottomRight());
+        move(bottomRight.x() - width(), bottomRight.y() - height());
+    }
+
+    m_lineEdit->setText(text);
+    onTextChanged(text);
+
+    show();
+    m_lineEdit->setFocus();
+}
+
+bool SymbolSearch::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_lineEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent*>(event);
+        int row = m_resultList->currentRow();
+
+        switch (keyEvent->key()) {
+        case Qt::Key_Down:
+            if (row + 1 < m_resultList->count()) {
+                m_resultList->setCurrentRow(row + 1);
+            }
+            return true;
+        case Qt::Key_Up:
+            if (row > 0) {
+                m_resultList->setCurrentRow(row - 1);
+            }
+            return true;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            acceptCurrent();
+            return true;
+        case Qt::Key_Escape:
+            hide();
+            return true;
+        default:
+            break;
+        }
+    }
+
+    return QFrame::eventFilter(watched, event);
+}
+
+void SymbolSearch::onTextChanged(const QString& text)
+{
+    m_resultList->clear();
+
+    const QVector<int> results = m_index.search(text, kMaxResults);
+    for (int entryIndex : results) {
+        const SymbolIndex::Entry& entry = m_index.entry(entryIndex);
+
+        QListWidgetItem *item = new QListWidgetItem(
+            QString("%1  %2  %3").arg(entry.code, entry.name, entry.initials));
+        item->setData(Qt::UserRole, entry.code);
+        m_resultList->addItem(item);
+    }
+
+    if (m_resultList->count() > 0) {
+        m_resultList->setCurrentRow(0);
+    }
+}
+
+void SymbolSearch::acceptCurrent()
+{
+    QListWidgetItem *item = m_resultList->currentItem();
+    if (item) {
+        hide();
+        emit stockChosen(item->data(Qt::UserRole).toString());
+    }
+}
+
+void SymbolSearch::setupUI()
+{
+    setFrameShape(QFrame::StyledPanel);
+    resize(260, 300);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(2, 2, 2, 2);
+    layout->setSpacing(2);
+
+    m_lineEdit = new QLineEdit();
+    m_lineEdit->setPlaceholderText(tr("代码/名称/拼音"));
+    m_lineEdit->installEventFilter(this);
+
+    m_resultList = new QListWidget();
+    m_resultList->setFocusPolicy(Qt::NoFocus);
+
+    layout->addWidget(m_lineEdit);
+    layout->addWidget(m_resultList);
+
+    connect(m_lineEdit, &QLineEdit::textChanged, this, &SymbolSearch::onTextChanged);
+    connect(m_resultList, &QListWidget::itemActivated, this, &SymbolSearch::acceptCurrent);
+    connect(m_resultList, &QListWidget::itemClicked, this, &SymbolSearch::acceptCurrent);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../data/symbolindex.h"
+#include <QFrame>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QKeyEvent>
+
+/**
+ * @brief 键盘精灵弹出框
+ *
+ * 输入股票代码、名称或拼音首字母，逐键即时显示匹配的股票
+ */
+class SymbolSearch : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit SymbolSearch(QWidget *parent = nullptr);
+    ~SymbolSearch();
+
+    /**
+     * @brief 设置市场数据，股票集合变化时重建索引
+     * @param marketData 市场数据
+     */
+    void setMarketData(const MarketData& marketData);
+
+    /**
+     * @brief 弹出键盘精灵
+     * @param text 初始输入文本（一般为触发弹出的按键）
+     */
+    void popup(const QString& text);
+
+signals:
+    /**
+     * @brief 选中股票信号
+     * @param code 股票代码
+     */
+    void stockChosen(const QString& code);
+
+protected:
+    /**
+     * @brief 拦截输入框的方向键和回车键
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    /**
+     * @brief 输入文本变化时刷新结果
+     * @param text 输入文本
+     */
+    void onTextChanged(const QString& text);
+
+    /**
+     * @brief 确认当前选中的结果
+     */
+    void acceptCurrent();
+
+private:
+    /**
+     * @brief 创建UI
+     */
+    void setupUI();
+
+private:
+    QLineEdit *m_lineEdit;       // 输入框
+    QListWidget *m_resultList;   // 结果列表
+    SymbolIndex m_index;         // 前缀索引
+
+    static const int kMaxResults = 20;  // 最多显示的结果数
+};
\ No newline at end of file